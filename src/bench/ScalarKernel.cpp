@@ -0,0 +1,89 @@
+// This is a catch module
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/SimpleBrot.hpp"
+
+// Standard
+#include <complex>
+
+
+// The original kernel, kept as the baseline to measure against
+// abs() takes a sqrt every iteration and pow() goes through the generic path
+template<class T>
+unsigned LegacyComputeIterationCount(
+  std::complex<T> const& c,
+  unsigned const maxIterations,
+  unsigned const bailout)
+{
+  std::complex<T> z;
+  unsigned iterationCount = 0;
+
+  while(abs(z) < bailout && iterationCount < maxIterations) {
+    z = pow(z, 2) + c;
+    iterationCount++;
+  }
+
+  return iterationCount;
+}
+
+
+// Iterate every pixel of a view with a kernel, returns the total count
+// so the work can't be optimised away
+template<class T, class Kernel>
+unsigned long long sumIterations(
+  unsigned const t_width,
+  unsigned const t_height,
+  unsigned const t_max_iterations,
+  Kernel t_kernel)
+{
+  // Left of the period 2 bulb, so the interior short circuit never fires
+  std::complex<T> start(-2.0, -0.35);
+  std::complex<T> end(-1.26, 0.35);
+
+  T r_step = (end.real() - start.real()) / t_width;
+  T i_step = (end.imag() - start.imag()) / t_height;
+
+  unsigned long long sum = 0;
+  for(unsigned i = 0; i < t_height; i++)
+  {
+    for(unsigned j = 0; j < t_width; j++)
+    {
+      std::complex<T> c(start.real() + (r_step * j), start.imag() + (i_step * i));
+      sum += t_kernel(c, t_max_iterations, 2);
+    }
+  }
+  return sum;
+}
+
+
+// Periodicity checks are left off and the view avoids the cardioid and
+// bulb, so both kernels do exactly the same number of iterations
+TEMPLATE_TEST_CASE(
+  "[Scalar kernel] - Squared magnitude kernel versus the original kernel",
+  "[benchmark]", float, double)
+{
+  unsigned width = 256;
+  unsigned height = 192;
+  unsigned max_iterations = 256;
+
+  auto legacy = [](std::complex<TestType> const& c, unsigned const m, unsigned const b) {
+    return LegacyComputeIterationCount(c, m, b);
+  };
+
+  auto squared = [](std::complex<TestType> const& c, unsigned const m, unsigned const b) {
+    return SimpleBrot::ComputeIterationCount(std::complex<TestType>(c.real(), c.imag()), m, b);
+  };
+
+  BENCHMARK("Original abs() and pow() kernel")
+  {
+    return sumIterations<TestType>(width, height, max_iterations, legacy);
+  };
+
+  BENCHMARK("Squared magnitude kernel")
+  {
+    return sumIterations<TestType>(width, height, max_iterations, squared);
+  };
+}
@@ -1,15 +1,29 @@
 
 // Internal
+#include "comm/AsyncConnection.hpp"
+#include "comm/Protocol.hpp"
 #include "draw/Image.hpp"
-#include "compute/SimpleBrot.hpp"
 
 // External
+#include "boost/asio.hpp"
 #include "optparse.hpp"
 #include "GLT/Window.hpp"
 
 // Standard
-#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <complex>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+using boost::asio::ip::tcp;
 
 
 // Generate option parser
@@ -35,10 +49,125 @@ OptionParser genOptionParser(int argc, char** argv)
     "Address of host compute server",
     {"127.0.0.1"}));
 
+  opt.Add(Option(
+    "frames", 'f', ARG_TYPE_INT,
+    "Number of frames to zoom through",
+    {"120"}));
+
+  opt.Add(Option(
+    "in-flight", 'i', ARG_TYPE_INT,
+    "Frames requested ahead of the one on screen",
+    {"4"}));
+
+  opt.Add(Option(
+    "zoom", 'z', ARG_TYPE_FLOAT,
+    "Scale of each frame relative to the last",
+    {"0.95"}));
+
   return opt;
 }
 
 
+// A frame requested from the server, kept until it has been shown
+struct ClientFrame
+{
+  unsigned maxIterations;
+  Buffer2D<float> counts;
+  std::vector<comm::TileHeader> arrived;
+  bool complete = false;
+
+  ClientFrame(unsigned const width, unsigned const height, unsigned const maxIterations) :
+    maxIterations(maxIterations), counts(width, height)
+  {}
+};
+
+
+// Frames in flight and the view on screen, shared with the io thread
+struct FramePipeline
+{
+  std::mutex mutex;
+  std::map<unsigned, std::unique_ptr<ClientFrame>> frames;
+  unsigned shown = 0;         // Frame whose tiles are on screen
+  Buffer2D<float> view;       // Iterations as a fraction of the maximum
+  bool changed = false;
+
+  // Put a tile of a frame on screen, caller holds the lock
+  void show(ClientFrame& frame, comm::TileHeader const& tile)
+  {
+    for(unsigned i = 0; i < tile.height; i++) {
+      for(unsigned j = 0; j < tile.width; j++) {
+        view.Get(tile.x + j, tile.y + i) = frame.counts.Get(tile.x + j, tile.y + i) / (float)frame.maxIterations;
+      }
+    }
+    changed = true;
+  }
+};
+
+
+// Colour an image from the view
+void colourImage(Buffer2D<float>& view, Image& image)
+{
+  for(unsigned i = 0; i < view.Height(); i++) {
+    for(unsigned j = 0; j < view.Width(); j++) {
+      unsigned char mag = std::min(view.Get(j, i), 1.0f) * 255;
+      image.Get(j, i) = {mag, mag, mag};
+    }
+  }
+}
+
+
+// File tiles and stats from the server, called on the io thread
+void handleMessage(
+  FramePipeline& pipeline,
+  comm::MessageHeader const& header,
+  std::vector<char> const& body,
+  std::vector<float>& values)
+{
+  if(header.type == comm::MessageType::TileResult)
+  {
+    comm::TileHeader tile = comm::DecodeTile(header, body, values);
+
+    std::lock_guard<std::mutex> lock(pipeline.mutex);
+    auto found = pipeline.frames.find(tile.frame);
+    if(found == pipeline.frames.end())
+    {
+      return;
+    }
+
+    // Written as differences so untrusted positions can't wrap
+    ClientFrame& frame = *found->second;
+    if(tile.x > frame.counts.Width() || tile.width > frame.counts.Width() - tile.x ||
+       tile.y > frame.counts.Height() || tile.height > frame.counts.Height() - tile.y)
+    {
+      throw std::runtime_error("tile outside frame");
+    }
+
+    for(unsigned i = 0; i < tile.height; i++) {
+      std::copy(&values[i * tile.width], &values[i * tile.width] + tile.width, &frame.counts.Get(tile.x, tile.y + i));
+    }
+    frame.arrived.push_back(tile);
+
+    if(tile.frame == pipeline.shown)
+    {
+      pipeline.show(frame, tile);
+    }
+  }
+  else if(header.type == comm::MessageType::Stats)
+  {
+    comm::Stats stats = comm::DecodeMessage<comm::Stats>(header, body);
+    std::cout << "Frame " << stats.frame << ", " << stats.tileCount << " tiles in " << stats.seconds << "s, ";
+    std::cout << stats.iteratedPixels << " pixels iterated, " << stats.extraSamples << " extra samples\n";
+
+    std::lock_guard<std::mutex> lock(pipeline.mutex);
+    auto found = pipeline.frames.find(stats.frame);
+    if(found != pipeline.frames.end())
+    {
+      found->second->complete = true;
+    }
+  }
+}
+
+
 // Lets get this show on the road
 int main(int argc, char **argv)
 {
@@ -65,50 +194,166 @@ int main(int argc, char **argv)
     GLT::Shader(GL_VERTEX_SHADER, "data/shaders/vs.glsl"),
     GLT::Shader(GL_FRAGMENT_SHADER, "data/shaders/fs.glsl")});
 
-//====[TEMPORARY]============================================================//
-
-  // Create image texture
-  Buffer2D<unsigned> iterationMap(width, height);
+  // Zoom from the overview towards a point, a frame at a time
+  std::complex<double> center(-0.5, 0);
+  std::complex<double> brotStart = center + std::complex<double>(-2, -1.5);
+  std::complex<double> brotEnd = center + std::complex<double>(2, 1.5);
+  std::complex<double> target(-0.743643887037151, 0.131825904205330);
 
-  // View positioning
-  std::complex<float> center(-0.5, 0);
-  std::complex<float> brotStart = center + std::complex<float>(-2, -1.5);
-  std::complex<float> brotEnd = center + std::complex<float>(2, 1.5);
+  int frameCount = opt.Get("frames");
+  int inFlight = std::max((int)opt.Get("in-flight"), 1);
+  float zoom = opt.Get("zoom");
 
-  // Maximum number of iterations
-  unsigned maxIterations = 64;
+  // Maximum number of iterations, grows as we zoom in
+  unsigned baseIterations = 64;
   unsigned bailout = 2;
   unsigned superSampling = 4;
 
-  // Compute iterations for all pixels
-  SimpleBrot::ComputeIterations(
-    iterationMap, brotStart, brotEnd, maxIterations, bailout, superSampling);
-
-//====[TEMPORARY]============================================================//
+  // Connect to the compute server
+  std::string host = opt.Get("host");
+  int port = opt.Get("port");
 
-  // Compute a mandelbrot image from iteration map
-  Image image(width, height);
-  for(int i = 0; i < height; i++) {
-    for(int j = 0; j < width; j++) {
-      float m = ((float)iterationMap.Get(j, i) / (float)maxIterations);
-      unsigned char mag = m * 255;
-      image.Get(j, i) = {mag, mag, mag};
-    }
+  boost::asio::io_service io;
+  tcp::socket socket(io);
+  try
+  {
+    tcp::resolver resolver(io);
+    boost::asio::connect(socket, resolver.resolve(tcp::resolver::query(host, std::to_string(port))));
+    socket.set_option(tcp::no_delay(true));
+  }
+  catch(boost::system::system_error const& e)
+  {
+    std::cerr << "ERROR, Could not connect to " << host << ":" << port << ", " << e.what() << "\n";
+    exit(1);
   }
 
-  // Update internal opengl texture
-  image.Update();
+  FramePipeline pipeline;
+  pipeline.view.Resize(width, height);
 
-  std::string host = opt.Get("host");
-  int port = opt.Get("port");
+  // Tiles are filed on the io thread while this one colours and uploads
+  std::vector<float> values;
+  std::shared_ptr<comm::AsyncConnection> connection(new comm::AsyncConnection(std::move(socket)));
+  std::weak_ptr<comm::AsyncConnection> weakConnection(connection);
+  connection->Start(
+    [&pipeline, &values, weakConnection](comm::MessageHeader const& header, std::vector<char> const& body)
+    {
+      try
+      {
+        handleMessage(pipeline, header, body, values);
+      }
+      catch(std::exception const& e)
+      {
+        std::cerr << "Bad message from server, " << e.what() << "\n";
+        if(std::shared_ptr<comm::AsyncConnection> connection = weakConnection.lock())
+        {
+          connection->Close();
+        }
+      }
+    },
+    [](boost::system::error_code const& error)
+    {
+      std::cout << "Disconnected from server, " << error.message() << "\n";
+    });
+
+  std::thread ioThread([&io]() {io.run();});
 
-  // Draw loop
+  // Ask for a frame of the zoom, all compute happens on the server
+  auto requestFrame = [&](unsigned const frame)
+  {
+    double const scale = std::pow(zoom, frame);
+    std::complex<double> const start = target + (brotStart - target) * scale;
+    std::complex<double> const end = target + (brotEnd - target) * scale;
+    unsigned const maxIterations = baseIterations * (1 + frame * -std::log2(zoom) / 2);
+
+    {
+      std::lock_guard<std::mutex> lock(pipeline.mutex);
+      pipeline.frames[frame] = std::unique_ptr<ClientFrame>(new ClientFrame(width, height, maxIterations));
+    }
+
+    comm::FrameRequest request = {
+      frame,
+      {{start.real(), 0, 0, 0}, {start.imag(), 0, 0, 0}},
+      {{end.real(), 0, 0, 0}, {end.imag(), 0, 0, 0}},
+      (unsigned)width, (unsigned)height, maxIterations, bailout, superSampling
+    };
+    connection->Send(request);
+  };
+
+  // Draw loop, keeping several frames in flight so the network stays busy
+  Image image(width, height);
+  unsigned nextFrame = 0;
   while(!window.ShouldClose())
   {
+    unsigned shown;
+    {
+      std::lock_guard<std::mutex> lock(pipeline.mutex);
+      shown = pipeline.shown;
+    }
+
+    while((int)nextFrame < frameCount && nextFrame < shown + inFlight)
+    {
+      requestFrame(nextFrame++);
+    }
+
+    bool upload = false;
+    {
+      std::lock_guard<std::mutex> lock(pipeline.mutex);
+
+      // Move on once the shown frame is finished and its successor requested
+      auto current = pipeline.frames.find(pipeline.shown);
+      if(current != pipeline.frames.end() && current->second->complete && pipeline.shown + 1 < nextFrame)
+      {
+        pipeline.frames.erase(current);
+        pipeline.shown++;
+
+        ClientFrame& next = *pipeline.frames[pipeline.shown];
+        for(comm::TileHeader const& tile : next.arrived)
+        {
+          pipeline.show(next, tile);
+        }
+      }
+
+      if(pipeline.changed)
+      {
+        colourImage(pipeline.view, image);
+        pipeline.changed = false;
+        upload = true;
+      }
+    }
+
+    // Upload outside the lock, tiles keep arriving meanwhile
+    if(upload)
+    {
+      image.Update();
+    }
+
     image.draw(shader);
     window.Refresh();
   }
 
+  // Stop the server working on frames nobody will see
+  {
+    std::vector<unsigned> unfinished;
+    {
+      std::lock_guard<std::mutex> lock(pipeline.mutex);
+      for(auto const& frame : pipeline.frames)
+      {
+        if(!frame.second->complete)
+        {
+          unfinished.push_back(frame.first);
+        }
+      }
+    }
+
+    for(unsigned frame : unfinished)
+    {
+      connection->Send(comm::Cancel{frame});
+    }
+  }
+  connection->Flush();
+  connection->Close();
+  ioThread.join();
+
   // El fin
   return 0;
 }
@@ -0,0 +1,308 @@
+#ifndef MPIBROT_COMM_ASYNCCONNECTION_INCLUDED
+#define MPIBROT_COMM_ASYNCCONNECTION_INCLUDED
+
+
+// Internal
+#include "comm/Protocol.hpp"
+
+// External
+#include "boost/asio.hpp"
+
+// Standard
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace comm {
+
+  // Protocol messages over a socket driven by an io_service
+  //
+  // Incoming messages are read with async_read and handed to the message
+  // handler on the io thread. The next read starts once the handler returns,
+  // so a slow consumer pushes back on its peer through TCP flow control.
+  //
+  // Outgoing messages are queued from any thread and written one at a time,
+  // header and payload gathered into a single async_write. Send blocks while
+  // more than maxQueuedBytes are waiting, so a slow peer pushes back on
+  // whatever is producing. Send must not be called from the io thread.
+  // TrySend never blocks, refusing the message instead. Producers that serve
+  // several peers and must not be held up by one, or lose what they already
+  // made, Queue regardless and stop producing for a peer while it is
+  // Backlogged. The drain handler tells them when to carry on.
+  //
+  // The io_service must be run by a single thread.
+  class AsyncConnection : public std::enable_shared_from_this<AsyncConnection> {
+  public:
+    typedef std::function<void(MessageHeader const&, std::vector<char> const&)> MessageHandler;
+    typedef std::function<void(boost::system::error_code const&)> CloseHandler;
+    typedef std::function<void()> DrainHandler;
+
+    // Largest body we are prepared to allocate for
+    static unsigned const MaxMessageLength = 1u << 28;
+
+  private:
+    // What to do with a message when the queue is full
+    enum class Admit {Wait, Refuse, Always};
+
+    struct Outgoing {
+      MessageHeader header;
+      std::vector<char> body;                             // Fixed size bodies
+      TileHeader tile;                                    // Or a tile, sharing its values
+      std::shared_ptr<std::vector<float> const> values;
+    };
+
+    boost::asio::ip::tcp::socket socket;
+    size_t const maxQueuedBytes;
+
+    std::mutex mutex;
+    std::condition_variable drained;
+    std::deque<Outgoing> outgoing;
+    size_t queuedBytes = 0;
+    bool writing = false;
+    bool closed = false;
+
+    MessageHeader incomingHeader;
+    std::vector<char> incomingBody;
+
+    MessageHandler onMessage;
+    CloseHandler onClose;
+    DrainHandler onDrained;
+
+
+    // Queue a message, what happens when the queue is full is up to admit
+    bool Enqueue(Outgoing&& message, Admit const admit) {
+      size_t const size = sizeof(MessageHeader) + message.header.length;
+
+      std::unique_lock<std::mutex> lock(this->mutex);
+      if(admit == Admit::Wait) {
+        this->drained.wait(lock, [this] {
+          return this->closed || this->queuedBytes < this->maxQueuedBytes;
+        });
+      }
+
+      if(this->closed || (admit != Admit::Always && this->queuedBytes >= this->maxQueuedBytes)) {
+        return false;
+      }
+
+      this->outgoing.push_back(std::move(message));
+      this->queuedBytes += size;
+
+      if(!this->writing) {
+        this->writing = true;
+        auto self = this->shared_from_this();
+        boost::asio::post(this->socket.get_executor(), [self] {self->WriteNext();});
+      }
+
+      return true;
+    }
+
+
+    // Write the message at the front of the queue, on the io thread
+    void WriteNext() {
+      std::unique_lock<std::mutex> lock(this->mutex);
+
+      if(this->closed || this->outgoing.empty()) {
+        this->writing = false;
+        return;
+      }
+
+      // Front stays put until its write completes, deque references survive push_back
+      Outgoing const& message = this->outgoing.front();
+      lock.unlock();
+
+      std::array<boost::asio::const_buffer, 3> buffers = {{
+        boost::asio::buffer(&message.header, sizeof(MessageHeader)),
+        boost::asio::const_buffer(),
+        boost::asio::const_buffer()
+      }};
+
+      if(message.header.type == MessageType::TileResult) {
+        buffers[1] = boost::asio::buffer(&message.tile, sizeof(TileHeader));
+        buffers[2] = boost::asio::buffer(message.values->data(), message.values->size() * sizeof(float));
+      } else {
+        buffers[1] = boost::asio::buffer(message.body.data(), message.body.size());
+      }
+
+      auto self = this->shared_from_this();
+      boost::asio::async_write(this->socket, buffers,
+        [self](boost::system::error_code const& error, size_t const size) {
+          if(error) {
+            self->Fail(error);
+            return;
+          }
+
+          bool relieved = false;
+          {
+            std::lock_guard<std::mutex> lock(self->mutex);
+            relieved = self->queuedBytes >= self->maxQueuedBytes;
+            self->outgoing.pop_front();
+            self->queuedBytes -= size;
+            relieved = relieved && self->queuedBytes < self->maxQueuedBytes;
+          }
+          self->drained.notify_all();
+
+          if(relieved && self->onDrained) {
+            self->onDrained();
+          }
+
+          self->WriteNext();
+        });
+    }
+
+
+    template<class T>
+    static Outgoing Message(T const& body) {
+      Outgoing message;
+      message.header = {MessageTypeOf<T>::value, sizeof(T)};
+      message.body.resize(sizeof(T));
+      std::memcpy(message.body.data(), &body, sizeof(T));
+      return message;
+    }
+
+
+    static Outgoing Message(TileHeader const& tile, std::shared_ptr<std::vector<float> const> values) {
+      Outgoing message;
+      message.header = {MessageType::TileResult, unsigned(sizeof(TileHeader) + values->size() * sizeof(float))};
+      message.tile = tile;
+      message.values = values;
+      return message;
+    }
+
+
+    void ReadHeader() {
+      auto self = this->shared_from_this();
+      boost::asio::async_read(this->socket, boost::asio::buffer(&this->incomingHeader, sizeof(MessageHeader)),
+        [self](boost::system::error_code const& error, size_t) {
+          if(error) {
+            self->Fail(error);
+            return;
+          }
+
+          if(self->incomingHeader.length > MaxMessageLength) {
+            self->Fail(boost::asio::error::message_size);
+            return;
+          }
+
+          self->incomingBody.resize(self->incomingHeader.length);
+          self->ReadBody();
+        });
+    }
+
+
+    void ReadBody() {
+      auto self = this->shared_from_this();
+      boost::asio::async_read(this->socket, boost::asio::buffer(this->incomingBody),
+        [self](boost::system::error_code const& error, size_t) {
+          if(error) {
+            self->Fail(error);
+            return;
+          }
+
+          self->onMessage(self->incomingHeader, self->incomingBody);
+          self->ReadHeader();
+        });
+    }
+
+
+    // Close once, waking any blocked senders
+    void Fail(boost::system::error_code const& error) {
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if(this->closed) {
+          return;
+        }
+        this->closed = true;
+        this->outgoing.clear();
+        this->queuedBytes = 0;
+      }
+      this->drained.notify_all();
+
+      boost::system::error_code ignored;
+      this->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+      this->socket.close(ignored);
+
+      if(this->onClose) {
+        this->onClose(error);
+      }
+    }
+
+  public:
+    AsyncConnection(boost::asio::ip::tcp::socket&& socket, size_t const maxQueuedBytes = 1u << 24) :
+      socket(std::move(socket)), maxQueuedBytes(maxQueuedBytes) {}
+
+    // Begin reading, handlers are called on the io thread
+    // onDrained, if given, runs each time the queue falls back below
+    // maxQueuedBytes.
+    void Start(MessageHandler onMessage, CloseHandler onClose, DrainHandler onDrained = nullptr) {
+      this->onMessage = onMessage;
+      this->onClose = onClose;
+      this->onDrained = onDrained;
+      auto self = this->shared_from_this();
+      boost::asio::post(this->socket.get_executor(), [self] {self->ReadHeader();});
+    }
+
+    // Queue a fixed size message, false if the connection has closed
+    template<class T>
+    bool Send(T const& body) {
+      return this->Enqueue(this->Message(body), Admit::Wait);
+    }
+
+    // As Send, but also false rather than waiting if the queue is full
+    template<class T>
+    bool TrySend(T const& body) {
+      return this->Enqueue(this->Message(body), Admit::Refuse);
+    }
+
+    // As Send, but queued even if the queue is full, see Backlogged
+    template<class T>
+    bool Queue(T const& body) {
+      return this->Enqueue(this->Message(body), Admit::Always);
+    }
+
+    // Queue a tile as Queue does, its values are shared rather than copied
+    bool QueueTile(TileHeader const& tile, std::shared_ptr<std::vector<float> const> values) {
+      return this->Enqueue(this->Message(tile, values), Admit::Always);
+    }
+
+    // Wait until everything queued has been written or the connection closed
+    void Flush() {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->drained.wait(lock, [this] {return this->closed || this->outgoing.empty();});
+    }
+
+    // Close from any thread, the close handler still runs
+    void Close() {
+      auto self = this->shared_from_this();
+      boost::asio::post(this->socket.get_executor(), [self] {
+        self->Fail(boost::asio::error::operation_aborted);
+      });
+    }
+
+    bool Closed() {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      return this->closed;
+    }
+
+    // Whether maxQueuedBytes or more are waiting to be written
+    bool Backlogged() {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      return this->queuedBytes >= this->maxQueuedBytes;
+    }
+
+    // Bytes waiting to be written
+    size_t QueuedBytes() {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      return this->queuedBytes;
+    }
+  };
+
+} // namespace comm
+
+
+#endif // MPIBROT_COMM_ASYNCCONNECTION_INCLUDED
@@ -0,0 +1,171 @@
+#ifndef MPIBROT_COMM_PROTOCOL_INCLUDED
+#define MPIBROT_COMM_PROTOCOL_INCLUDED
+
+
+// Standard
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+
+// Client/server messages are a MessageHeader followed by length bytes of
+// body. Fixed size bodies are the structs below, a tile is a TileHeader
+// followed by its continuous iteration counts.
+namespace comm {
+
+  enum class MessageType : unsigned {
+    FrameRequest = 1,   // Client to server
+    TileResult = 2,     // Server to client
+    Cancel = 3,         // Client to server
+    Stats = 4           // Server to client, once a frame is complete
+  };
+
+
+  struct MessageHeader {
+    MessageType type;
+    unsigned length;          // Body size in bytes
+  };
+
+
+  // A frame the client wants rendered
+  // Viewport corners are quad-double components, most significant first.
+  struct FrameRequest {
+    unsigned frame;           // Client chosen id, echoed in every reply
+    double start[2][4];       // Real and imaginary parts
+    double end[2][4];
+    unsigned width;
+    unsigned height;
+    unsigned maxIterations;
+    unsigned bailout;
+    unsigned supersampling;
+  };
+
+
+  // Sent ahead of the continuous iteration counts of each rendered tile
+  struct TileHeader {
+    unsigned frame;
+    unsigned index;
+    unsigned tileCount;       // Tiles in the whole frame
+    unsigned x;               // Pixel rectangle within the frame
+    unsigned y;
+    unsigned width;
+    unsigned height;
+  };
+
+
+  // Stop rendering a frame, tiles already in flight may still arrive
+  struct Cancel {
+    unsigned frame;
+  };
+
+
+  // Totals for a completed frame
+  struct Stats {
+    unsigned frame;
+    unsigned tileCount;
+    double seconds;           // From request arriving to last tile sent
+    unsigned long long iteratedPixels;
+    unsigned long long filledPixels;
+    unsigned long long interiorShortCircuits;
+    unsigned long long periodicExits;
+    unsigned long long extraSamples;
+  };
+
+
+  // Map fixed size bodies to their message type
+  template<class T> struct MessageTypeOf;
+  template<> struct MessageTypeOf<FrameRequest> {static MessageType const value = MessageType::FrameRequest;};
+  template<> struct MessageTypeOf<Cancel> {static MessageType const value = MessageType::Cancel;};
+  template<> struct MessageTypeOf<Stats> {static MessageType const value = MessageType::Stats;};
+
+
+  // Decode a fixed size message body already read into memory
+  template<class T>
+  T DecodeMessage(MessageHeader const& header, std::vector<char> const& body) {
+    if(header.type != MessageTypeOf<T>::value || header.length != sizeof(T) || body.size() != sizeof(T)) {
+      throw std::runtime_error("malformed message");
+    }
+    T message;
+    std::memcpy(&message, body.data(), sizeof(T));
+    return message;
+  }
+
+
+  // Largest frame a server will render, requests beyond it are refused
+  struct FrameLimits {
+    unsigned long long maxPixels = 4096ull * 4096ull;
+    unsigned maxSupersampling = 8;
+    unsigned maxIterations = 1u << 20;
+    unsigned maxBailout = 1u << 16;
+  };
+
+
+  // Check a decoded frame request can be rendered within limits
+  // Throws on non-finite viewports, viewports whose pixel spacing is zero
+  // or too small for a double, empty frames and parameters out of range,
+  // everything in a request comes straight off the socket.
+  inline void ValidateFrameRequest(FrameRequest const& request, FrameLimits const& limits) {
+    if(request.width == 0 || request.height == 0) {
+      throw std::runtime_error("empty frame");
+    }
+
+    unsigned const pixels[2] = {request.width, request.height};
+
+    for(unsigned i = 0; i < 2; i++) {
+      double span = 0;
+      for(unsigned j = 0; j < 4; j++) {
+        if(!std::isfinite(request.start[i][j]) || !std::isfinite(request.end[i][j])) {
+          throw std::runtime_error("non-finite viewport");
+        }
+        span += request.end[i][j] - request.start[i][j];
+      }
+
+      // Renders narrow the spacing to a double, it must survive that
+      double const step = span / pixels[i];
+      if(!std::isnormal(step)) {
+        throw std::runtime_error("viewport spacing out of range");
+      }
+    }
+
+    if((unsigned long long)(request.width) * request.height > limits.maxPixels) {
+      throw std::runtime_error("frame too large");
+    }
+    if(request.supersampling == 0 || request.supersampling > limits.maxSupersampling) {
+      throw std::runtime_error("supersampling out of range");
+    }
+    if(request.maxIterations == 0 || request.maxIterations > limits.maxIterations) {
+      throw std::runtime_error("iteration limit out of range");
+    }
+    if(request.bailout == 0 || request.bailout > limits.maxBailout) {
+      throw std::runtime_error("bailout out of range");
+    }
+  }
+
+
+  // Decode a tile message body already read into memory
+  inline TileHeader DecodeTile(MessageHeader const& header, std::vector<char> const& body, std::vector<float>& values) {
+    if(header.type != MessageType::TileResult || body.size() < sizeof(TileHeader)) {
+      throw std::runtime_error("malformed message");
+    }
+
+    TileHeader tile;
+    std::memcpy(&tile, body.data(), sizeof(TileHeader));
+    // Sizes in 64 bits, a 32 bit product of untrusted dimensions can wrap
+    // round to match a short body
+    std::uint64_t const count = std::uint64_t(tile.width) * tile.height;
+    if(count > (body.size() - sizeof(TileHeader)) / sizeof(float) ||
+       body.size() - sizeof(TileHeader) != count * sizeof(float)) {
+      throw std::runtime_error("malformed tile");
+    }
+
+    values.resize(count);
+    std::memcpy(values.data(), body.data() + sizeof(TileHeader), count * sizeof(float));
+    return tile;
+  }
+
+} // namespace comm
+
+
+#endif // MPIBROT_COMM_PROTOCOL_INCLUDED
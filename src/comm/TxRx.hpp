@@ -46,8 +46,7 @@ void Receive(std::vector<T>* data, boost::asio::ip::tcp::socket& socket) {
   }
 
   // Read storage back
-  read(socket, boost::asio::buffer(data->data(), sizeof(T)) * elementCount);
-  return data;
+  read(socket, boost::asio::buffer(data->data(), sizeof(T) * elementCount));
 }
 
 
@@ -0,0 +1,195 @@
+#ifndef MPIBROT_COMPUTE_ADAPTIVESUPERSAMPLE_INCLUDED
+#define MPIBROT_COMPUTE_ADAPTIVESUPERSAMPLE_INCLUDED
+
+
+// Internal
+#include "compute/KernelStats.hpp"
+#include "compute/SimpleBrot.hpp"
+#include "util/Buffer2D.hpp"
+
+// Standard
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+
+namespace SimpleBrot {
+
+  // Deterministic jitter in [0, 1) for draw k of pixel (x, y)
+  // A splitmix64 hash rather than a generator, so a pixel gets the same
+  // subsamples however the frame is split up or ordered
+  inline double Jitter(unsigned const x, unsigned const y, unsigned const k) {
+    uint64_t h = (uint64_t(x) << 40) ^ (uint64_t(y) << 16) ^ k;
+    h += 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    return double(h >> 11) / double(1ull << 53);
+  }
+
+
+  // Whether a pixel differs from any of its 8 neighbours by more than threshold
+  // Pixels on the border of data only compare against neighbours inside it
+  inline bool IsEdge(Buffer2D<float>& data, unsigned const x, unsigned const y, float const threshold) {
+    float const centre = data.Get(x, y);
+    unsigned const x0 = x > 0 ? x - 1 : x;
+    unsigned const y0 = y > 0 ? y - 1 : y;
+    unsigned const x1 = x + 1 < data.Width() ? x + 1 : x;
+    unsigned const y1 = y + 1 < data.Height() ? y + 1 : y;
+
+    for(unsigned ny = y0; ny <= y1; ny++) {
+      for(unsigned nx = x0; nx <= x1; nx++) {
+        if(std::fabs(data.Get(nx, ny) - centre) > threshold) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+
+  // Mark every pixel of data that is an edge, in row major order
+  inline std::vector<bool> FindEdges(Buffer2D<float>& data, float const threshold) {
+    std::vector<bool> edge(data.Width() * data.Height());
+    for(unsigned i = 0; i < data.Height(); i++) {
+      for(unsigned j = 0; j < data.Width(); j++) {
+        edge[i * data.Width() + j] = IsEdge(data, j, i, threshold);
+      }
+    }
+    return edge;
+  }
+
+
+  // Antialias a 1x buffer of continuous counts where it has edges
+  // Pixels differing from a neighbour by more than threshold are split into
+  // scale x scale strata. The existing sample sits at the pixel corner and
+  // stands in for the first stratum, every other stratum gets one sample at
+  // a jittered position inside it, and the pixel becomes their mean. Flat
+  // regions, which are most of a typical frame, are left at one sample.
+  // originX and originY place data within a larger frame, jitter is keyed
+  // on frame pixels so a tile gets the same subsamples as the whole frame.
+  // The edges are found before any pixel changes, a tile passes the edges
+  // of its frame so its border pixels see their neighbours in other tiles.
+  // sample(x, y) returns the continuous count at a point given in frame
+  // pixels, so parts of a frame sample exactly the points the whole would.
+  template<class Sample>
+  void SupersampleEdgesWith(
+    Buffer2D<float>& data,
+    std::vector<bool> const& edge,
+    unsigned const scale,
+    KernelStats* stats,
+    unsigned const originX,
+    unsigned const originY,
+    Sample const& sample) {
+
+    if(scale < 2) {
+      return;
+    }
+
+    for(unsigned i = 0; i < data.Height(); i++) {
+      for(unsigned j = 0; j < data.Width(); j++) {
+        if(!edge[i * data.Width() + j]) {
+          continue;
+        }
+
+        float sum = data.Get(j, i);
+        for(unsigned k = 0; k < scale; k++) {
+          for(unsigned l = 0; l < scale; l++) {
+            if(k == 0 && l == 0) {
+              continue;
+            }
+
+            unsigned const draw = 2 * (k * scale + l);
+            double const x = (originX + j) + (l + Jitter(originX + j, originY + i, draw)) / scale;
+            double const y = (originY + i) + (k + Jitter(originX + j, originY + i, draw + 1)) / scale;
+            sum += sample(x, y);
+          }
+        }
+        data.Get(j, i) = sum / (scale * scale);
+
+        if(stats != nullptr) {
+          stats->extraSamples += scale * scale - 1;
+        }
+      }
+    }
+  }
+
+
+  // Supersample the given edges of part of a pixel grid rendered directly
+  // at type T, data and the grid are as in FillSmoothIterationGrid
+  template<class T>
+  void SupersampleGridEdges(
+    Buffer2D<float>& data,
+    std::complex<T> const start,
+    T const rStep,
+    T const iStep,
+    unsigned const originX,
+    unsigned const originY,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    unsigned const scale,
+    std::vector<bool> const& edge,
+    KernelStats* stats = nullptr) {
+
+    if(scale < 2) {
+      return;
+    }
+
+    T tolerance = PeriodicityTolerance(rStep, iStep) / T(scale);
+
+    SupersampleEdgesWith(data, edge, scale, stats, originX, originY,
+      [&](double const x, double const y) {
+        std::complex<T> c = std::complex<T>(
+          start.real() + (rStep * T(x)),
+          start.imag() + (iStep * T(y)));
+        return ComputeSmoothIterationCount(c, maxIterations, bailout, tolerance, stats);
+      });
+  }
+
+
+  // Supersample the edges of a buffer rendered directly at type T
+  template<class T>
+  void SupersampleEdges(
+    Buffer2D<float>& data,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    unsigned const scale,
+    float const threshold,
+    KernelStats* stats = nullptr) {
+
+    if(scale < 2) {
+      return;
+    }
+
+    T rStep = (end.real() - start.real()) / data.Width();
+    T iStep = (end.imag() - start.imag()) / data.Height();
+
+    SupersampleGridEdges(
+      data, start, rStep, iStep, 0, 0, maxIterations, bailout, scale, FindEdges(data, threshold), stats);
+  }
+
+
+  // Adaptively supersampled continuous iteration count
+  // Renders at one sample per pixel, then refines only the edges
+  template<class T>
+  void ComputeAdaptiveIterations(
+    Buffer2D<float>& data,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    unsigned const scale,
+    float const threshold = 1.0f,
+    KernelStats* stats = nullptr) {
+
+    FillSmoothIterationBuffer(data, start, end, maxIterations, bailout, stats);
+    SupersampleEdges(data, start, end, maxIterations, bailout, scale, threshold, stats);
+  }
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_ADAPTIVESUPERSAMPLE_INCLUDED
@@ -0,0 +1,134 @@
+#ifndef MPIBROT_COMPUTE_BOUNDARYTRACE_INCLUDED
+#define MPIBROT_COMPUTE_BOUNDARYTRACE_INCLUDED
+
+
+// Internal
+#include "compute/LazyIterationBuffer.hpp"
+#include "compute/KernelStats.hpp"
+#include "util/Buffer2D.hpp"
+
+// Standard
+#include <complex>
+#include <deque>
+#include <vector>
+
+
+namespace SimpleBrot {
+
+  // Boundary tracing fill
+  // Starting from the buffer's edges, every pixel that differs from one of
+  // its neighbours is on the boundary between two iteration bands, so its
+  // neighbours are queued and iterated too. This walks the edges of every band
+  // that touches the buffer edge. Whatever was never reached lies inside a
+  // closed boundary and is flood filled from its left hand neighbour. Each
+  // buffer is independent, so tiles can be traced in parallel.
+  template<class T>
+  class BoundaryTrace {
+  private:
+
+    LazyIterationBuffer<T> buffer;
+    std::vector<bool> queued;
+    std::deque<unsigned> queue;
+
+
+    void Enqueue(unsigned const x, unsigned const y) {
+      unsigned const index = y * this->buffer.Width() + x;
+      if(!this->queued[index]) {
+        this->queued[index] = true;
+        this->queue.push_back(index);
+      }
+    }
+
+
+    // Queue the neighbours of a pixel that sits on a band boundary
+    void Scan(unsigned const x, unsigned const y) {
+      unsigned const w = this->buffer.Width();
+      unsigned const h = this->buffer.Height();
+      unsigned const center = this->buffer.Evaluate(x, y);
+
+      bool const hasLeft = x > 0;
+      bool const hasRight = x + 1 < w;
+      bool const hasUp = y > 0;
+      bool const hasDown = y + 1 < h;
+
+      bool const left = hasLeft && this->buffer.Evaluate(x - 1, y) != center;
+      bool const right = hasRight && this->buffer.Evaluate(x + 1, y) != center;
+      bool const up = hasUp && this->buffer.Evaluate(x, y - 1) != center;
+      bool const down = hasDown && this->buffer.Evaluate(x, y + 1) != center;
+
+      if(left) this->Enqueue(x - 1, y);
+      if(right) this->Enqueue(x + 1, y);
+      if(up) this->Enqueue(x, y - 1);
+      if(down) this->Enqueue(x, y + 1);
+
+      // Diagonals keep 8-connected boundaries from leaking
+      if(hasUp && hasLeft && (left || up)) this->Enqueue(x - 1, y - 1);
+      if(hasUp && hasRight && (right || up)) this->Enqueue(x + 1, y - 1);
+      if(hasDown && hasLeft && (left || down)) this->Enqueue(x - 1, y + 1);
+      if(hasDown && hasRight && (right || down)) this->Enqueue(x + 1, y + 1);
+    }
+
+  public:
+
+    BoundaryTrace(
+      Buffer2D<unsigned>& data,
+      std::complex<T> const start,
+      std::complex<T> const end,
+      unsigned const maxIterations,
+      unsigned const bailout,
+      KernelStats* stats) :
+      buffer(data, start, end, maxIterations, bailout, stats),
+      queued(data.Width() * data.Height(), false) {}
+
+    void Fill() {
+      unsigned const w = this->buffer.Width();
+      unsigned const h = this->buffer.Height();
+
+      // Seed with the buffer edges
+      for(unsigned x = 0; x < w; x++) {
+        this->Enqueue(x, 0);
+        this->Enqueue(x, h - 1);
+      }
+      for(unsigned y = 0; y < h; y++) {
+        this->Enqueue(0, y);
+        this->Enqueue(w - 1, y);
+      }
+
+      // Trace boundaries
+      while(!this->queue.empty()) {
+        unsigned const index = this->queue.front();
+        this->queue.pop_front();
+        this->Scan(index % w, index / w);
+      }
+
+      // Fill enclosed regions, the left column is always traced
+      for(unsigned y = 0; y < h; y++) {
+        for(unsigned x = 1; x < w; x++) {
+          if(!this->buffer.Done(x, y)) {
+            this->buffer.Fill(x, y, this->buffer.Evaluate(x - 1, y));
+          }
+        }
+      }
+    }
+  };
+
+
+  // Generate a 2d buffer full of iteration counts by tracing band boundaries
+  template<class T>
+  void FillIterationBufferBoundaryTrace(
+    Buffer2D<unsigned>& data,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    KernelStats* stats = nullptr) {
+
+    if(data.Width() > 0 && data.Height() > 0) {
+      BoundaryTrace<T>(data, start, end, maxIterations, bailout, stats).Fill();
+    }
+  }
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_BOUNDARYTRACE_INCLUDED
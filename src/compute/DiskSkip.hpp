@@ -0,0 +1,168 @@
+#ifndef MPIBROT_COMPUTE_DISKSKIP_INCLUDED
+#define MPIBROT_COMPUTE_DISKSKIP_INCLUDED
+
+
+// Internal
+#include "compute/Escape.hpp"
+#include "compute/KernelStats.hpp"
+#include "compute/SimpleBrot.hpp"
+#include "util/Buffer2D.hpp"
+
+// Standard
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+
+namespace SimpleBrot {
+
+  // Exterior disk skipping
+  // Pixels are visited in scan order. Each pixel not yet covered is iterated
+  // along with its derivative, and its distance estimate gives a disk around
+  // c that holds no point of the set. Every pixel centre inside that disk is
+  // exterior, so it is filled instead of iterated, taking the centre's
+  // distance less its offset. Only distances are produced, a filled pixel's
+  // iteration count is never known.
+  template<class T>
+  class DiskSkip {
+  private:
+
+    // Fraction of the distance estimate trusted as empty, Koebe's theorem
+    // guarantees a quarter of Milnor's bound, which is half the estimate,
+    // and a further half covers the error left at DistanceRadius
+    static constexpr double SafeFraction = 0.25;
+
+    Buffer2D<float>& distance;
+    std::vector<bool> done;
+
+    T const re0;
+    T const im0;
+    T const rStep;
+    T const iStep;
+    T const tolerance;
+
+    unsigned const maxIterations;
+    unsigned const bailout;
+
+    KernelStats* stats;
+
+
+    // Whole pixels of size step within distance, at most limit
+    // Clamped in double, far from the set or at deep zoom the quotient can
+    // be far beyond unsigned or infinite
+    static unsigned Reach(double const distance, double const step, unsigned const limit) {
+      double const pixels = distance / step;
+      return pixels < double(limit) ? unsigned(pixels) : limit;
+    }
+
+    // Fill the pixels inside a disk of radius r around pixel (x, y)
+    void FillDisk(unsigned const x, unsigned const y, double const r) {
+      double const dx = std::fabs(ToDouble(this->rStep));
+      double const dy = std::fabs(ToDouble(this->iStep));
+      float const centre = this->distance.Get(x, y);
+
+      unsigned const y1 = y + Reach(r, dy, this->distance.Height() - 1 - y);
+
+      // Rows above are already done, scan order only looks ahead
+      for(unsigned py = y; py <= y1; py++) {
+        double const oy = (double(py) - double(y)) * dy;
+        double const halfChord = std::sqrt(std::max(0.0, r * r - oy * oy));
+        unsigned const px0 = (py == y) ? x + 1 : x - Reach(halfChord, dx, x);
+        unsigned const px1 = x + Reach(halfChord, dx, this->distance.Width() - 1 - x);
+
+        for(unsigned px = px0; px <= px1; px++) {
+          if(this->done[py * this->distance.Width() + px]) {
+            continue;
+          }
+
+          double const ox = (double(px) - double(x)) * dx;
+          double const offset = std::sqrt(ox * ox + oy * oy);
+          if(offset >= r) {
+            continue;
+          }
+
+          this->distance.Get(px, py) = float(std::max(0.0, centre - offset));
+          this->done[py * this->distance.Width() + px] = true;
+
+          if(this->stats != nullptr) {
+            this->stats->filledPixels++;
+          }
+        }
+      }
+    }
+
+  public:
+
+    DiskSkip(
+      Buffer2D<float>& distance,
+      std::complex<T> const start,
+      std::complex<T> const end,
+      unsigned const maxIterations,
+      unsigned const bailout,
+      KernelStats* stats) :
+      distance(distance),
+      done(distance.Width() * distance.Height(), false),
+      re0(start.real()),
+      im0(start.imag()),
+      rStep((end.real() - start.real()) / distance.Width()),
+      iStep((end.imag() - start.imag()) / distance.Height()),
+      tolerance(PeriodicityTolerance(rStep, iStep)),
+      maxIterations(maxIterations),
+      bailout(bailout),
+      stats(stats) {}
+
+    void Fill() {
+      for(unsigned y = 0; y < this->distance.Height(); y++) {
+        for(unsigned x = 0; x < this->distance.Width(); x++) {
+          if(this->done[y * this->distance.Width() + x]) {
+            continue;
+          }
+
+          std::complex<T> c = std::complex<T>(
+            this->re0 + (this->rStep * x),
+            this->im0 + (this->iStep * y));
+
+          EscapeState<T> escape;
+          escape.trackDerivative = true;
+          unsigned const count = ComputeIterationCount(
+            c, this->maxIterations, this->bailout, this->tolerance, this->stats, &escape);
+
+          this->distance.Get(x, y) = DistanceEstimate(count, this->maxIterations, escape, c.real(), c.imag());
+          this->done[y * this->distance.Width() + x] = true;
+
+          if(this->stats != nullptr) {
+            this->stats->iteratedPixels++;
+          }
+
+          // Huge estimates far from the set can overflow to infinity
+          double const r = SafeFraction * this->distance.Get(x, y);
+          if(r > 0 && std::isfinite(r)) {
+            this->FillDisk(x, y, r);
+          }
+        }
+      }
+    }
+  };
+
+
+  // Generate distance estimates, skipping exterior disks
+  // Interior pixels get 0 as with FillDistanceEstimateBuffer. There is no
+  // iteration count output, skipped pixels are never iterated, so renders
+  // that need counts use FillDistanceEstimateBuffer instead.
+  template<class T>
+  void FillDistanceBufferDiskSkip(
+    Buffer2D<float>& distance,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    KernelStats* stats = nullptr) {
+
+    DiskSkip<T>(distance, start, end, maxIterations, bailout, stats).Fill();
+  }
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_DISKSKIP_INCLUDED
@@ -0,0 +1,82 @@
+#ifndef MPIBROT_COMPUTE_DISPATCH_INCLUDED
+#define MPIBROT_COMPUTE_DISPATCH_INCLUDED
+
+
+// Internal
+#include "compute/Engine.hpp"
+
+// Standard
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+
+namespace SimpleBrot {
+
+  // Whether the CPU we are running on can execute an engine's kernels
+  // __builtin_cpu_supports reads cpuid, including OS support for the
+  // wider register state, so this is safe on heterogeneous clusters
+  inline bool EngineSupported(Engine const engine) {
+    switch(engine) {
+      case Engine::Scalar: return true;
+      case Engine::Sse2: return __builtin_cpu_supports("sse2");
+      case Engine::Avx2: return __builtin_cpu_supports("avx2");
+      case Engine::Avx512: return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+  }
+
+
+  // All engines, narrowest first
+  inline std::vector<Engine> AllEngines() {
+    return {Engine::Scalar, Engine::Sse2, Engine::Avx2, Engine::Avx512};
+  }
+
+
+  // Widest engine this CPU supports
+  inline Engine DetectEngine() {
+    Engine best = Engine::Scalar;
+    for(Engine const engine : AllEngines()) {
+      if(EngineSupported(engine)) {
+        best = engine;
+      }
+    }
+    return best;
+  }
+
+
+  // Human readable engine names, these are also the option values
+  inline std::string EngineName(Engine const engine) {
+    switch(engine) {
+      case Engine::Scalar: return "scalar";
+      case Engine::Sse2: return "sse2";
+      case Engine::Avx2: return "avx2";
+      case Engine::Avx512: return "avx512";
+    }
+    return "unknown";
+  }
+
+
+  // Pick an engine from a user supplied name, "auto" detects
+  // Throws if the name is unknown or this CPU can't run the engine
+  inline Engine SelectEngine(std::string const& name) {
+    if(name == "auto") {
+      return DetectEngine();
+    }
+
+    for(Engine const engine : AllEngines()) {
+      if(EngineName(engine) == name) {
+        if(!EngineSupported(engine)) {
+          throw std::runtime_error("engine '" + name + "' is not supported by this CPU");
+        }
+        return engine;
+      }
+    }
+
+    throw std::invalid_argument("unknown engine '" + name + "'");
+  }
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_DISPATCH_INCLUDED
@@ -0,0 +1,188 @@
+#ifndef MPIBROT_COMPUTE_DOUBLEDOUBLE_INCLUDED
+#define MPIBROT_COMPUTE_DOUBLEDOUBLE_INCLUDED
+
+
+namespace SimpleBrot {
+
+  // Double-double arithmetic, an unevaluated sum hi + lo of two doubles with
+  // |lo| <= ulp(hi) / 2, giving ~106 bits of mantissa in hardware arithmetic.
+  // The algorithms are written once over a lane type L providing Add, Sub,
+  // Mul and Set1 on doubles, so the scalar type below and the vectorised
+  // lanes in simd/ produce identical bits. Products are split with Dekker's
+  // method rather than FMA, so this relies on -ffp-contract=off wherever
+  // the compiler could fuse them (see ISA_FLAGS in the Makefile).
+  template<class L>
+  struct DoubleDoubleArithmetic {
+    typedef typename L::Vec Vec;
+
+    struct Value {
+      Vec hi;
+      Vec lo;
+    };
+
+    // s + e == a + b exactly, assuming |a| >= |b|
+    static inline Value QuickTwoSum(Vec const a, Vec const b) {
+      Vec const s = L::Add(a, b);
+      return {s, L::Sub(b, L::Sub(s, a))};
+    }
+
+    // s + e == a + b exactly
+    static inline Value TwoSum(Vec const a, Vec const b) {
+      Vec const s = L::Add(a, b);
+      Vec const bb = L::Sub(s, a);
+      return {s, L::Add(L::Sub(a, L::Sub(s, bb)), L::Sub(b, bb))};
+    }
+
+    // s + e == a - b exactly
+    static inline Value TwoDiff(Vec const a, Vec const b) {
+      Vec const s = L::Sub(a, b);
+      Vec const bb = L::Sub(s, a);
+      return {s, L::Sub(L::Sub(a, L::Sub(s, bb)), L::Add(b, bb))};
+    }
+
+    // Split a into two 26 bit halves
+    static inline Value Split(Vec const a) {
+      Vec const t = L::Mul(L::Set1(134217729.0), a);
+      Vec const hi = L::Sub(t, L::Sub(t, a));
+      return {hi, L::Sub(a, hi)};
+    }
+
+    // p + e == a * b exactly
+    static inline Value TwoProd(Vec const a, Vec const b) {
+      Vec const p = L::Mul(a, b);
+      Value const as = Split(a);
+      Value const bs = Split(b);
+      Vec const e = L::Add(
+        L::Add(L::Add(L::Sub(L::Mul(as.hi, bs.hi), p), L::Mul(as.hi, bs.lo)), L::Mul(as.lo, bs.hi)),
+        L::Mul(as.lo, bs.lo));
+      return {p, e};
+    }
+
+    // p + e == a * a exactly
+    static inline Value TwoSquare(Vec const a) {
+      Vec const p = L::Mul(a, a);
+      Value const as = Split(a);
+      Vec const e = L::Add(
+        L::Add(L::Sub(L::Mul(as.hi, as.hi), p), L::Mul(L::Add(as.hi, as.hi), as.lo)),
+        L::Mul(as.lo, as.lo));
+      return {p, e};
+    }
+
+    static inline Value Add(Value const a, Value const b) {
+      Value s = TwoSum(a.hi, b.hi);
+      Value const t = TwoSum(a.lo, b.lo);
+      s.lo = L::Add(s.lo, t.hi);
+      s = QuickTwoSum(s.hi, s.lo);
+      s.lo = L::Add(s.lo, t.lo);
+      return QuickTwoSum(s.hi, s.lo);
+    }
+
+    static inline Value Sub(Value const a, Value const b) {
+      Value s = TwoDiff(a.hi, b.hi);
+      Value const t = TwoDiff(a.lo, b.lo);
+      s.lo = L::Add(s.lo, t.hi);
+      s = QuickTwoSum(s.hi, s.lo);
+      s.lo = L::Add(s.lo, t.lo);
+      return QuickTwoSum(s.hi, s.lo);
+    }
+
+    static inline Value Mul(Value const a, Value const b) {
+      Value p = TwoProd(a.hi, b.hi);
+      p.lo = L::Add(p.lo, L::Add(L::Mul(a.hi, b.lo), L::Mul(a.lo, b.hi)));
+      return QuickTwoSum(p.hi, p.lo);
+    }
+
+    // Cheaper than Mul(a, a), one split and one cross term
+    static inline Value Square(Value const a) {
+      Value p = TwoSquare(a.hi);
+      p.lo = L::Add(p.lo, L::Mul(L::Add(a.hi, a.hi), a.lo));
+      return QuickTwoSum(p.hi, p.lo);
+    }
+  };
+
+
+  // Plain doubles as a single lane
+  struct ScalarDoubleLane {
+    typedef double Vec;
+    static inline double Set1(double const x) {return x;}
+    static inline double Add(double const a, double const b) {return a + b;}
+    static inline double Sub(double const a, double const b) {return a - b;}
+    static inline double Mul(double const a, double const b) {return a * b;}
+  };
+
+
+  // Double-double value type, usable as T in the SimpleBrot templates
+  class DoubleDouble {
+  private:
+    typedef DoubleDoubleArithmetic<ScalarDoubleLane> Arithmetic;
+
+    DoubleDouble(Arithmetic::Value const v) : hi(v.hi), lo(v.lo) {}
+    Arithmetic::Value Get() const {return {this->hi, this->lo};}
+
+  public:
+    double hi;
+    double lo;
+
+    DoubleDouble(double const x = 0) : hi(x), lo(0) {}
+    DoubleDouble(double const hi, double const lo) : hi(hi), lo(lo) {}
+
+    double ToDouble() const {return this->hi + this->lo;}
+
+    friend DoubleDouble operator+(DoubleDouble const& a, DoubleDouble const& b) {
+      return Arithmetic::Add(a.Get(), b.Get());
+    }
+
+    friend DoubleDouble operator-(DoubleDouble const& a, DoubleDouble const& b) {
+      return Arithmetic::Sub(a.Get(), b.Get());
+    }
+
+    friend DoubleDouble operator*(DoubleDouble const& a, DoubleDouble const& b) {
+      return Arithmetic::Mul(a.Get(), b.Get());
+    }
+
+    // Long division, only used for setting up pixel steps
+    friend DoubleDouble operator/(DoubleDouble const& a, DoubleDouble const& b) {
+      double const q1 = a.hi / b.hi;
+      DoubleDouble r = a - b * DoubleDouble(q1);
+      double const q2 = r.hi / b.hi;
+      r = r - b * DoubleDouble(q2);
+      double const q3 = r.hi / b.hi;
+      return DoubleDouble(Arithmetic::QuickTwoSum(q1, q2)) + DoubleDouble(q3);
+    }
+
+    friend DoubleDouble operator-(DoubleDouble const& a) {
+      return DoubleDouble(-a.hi, -a.lo);
+    }
+
+    friend DoubleDouble Square(DoubleDouble const& a) {
+      return Arithmetic::Square(a.Get());
+    }
+
+    DoubleDouble& operator+=(DoubleDouble const& b) {return *this = *this + b;}
+    DoubleDouble& operator-=(DoubleDouble const& b) {return *this = *this - b;}
+    DoubleDouble& operator*=(DoubleDouble const& b) {return *this = *this * b;}
+    DoubleDouble& operator/=(DoubleDouble const& b) {return *this = *this / b;}
+
+    // Normalised values compare on hi first, then lo
+    friend bool operator<(DoubleDouble const& a, DoubleDouble const& b) {
+      return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+    }
+
+    friend bool operator<=(DoubleDouble const& a, DoubleDouble const& b) {
+      return a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo);
+    }
+
+    friend bool operator>(DoubleDouble const& a, DoubleDouble const& b) {return b < a;}
+    friend bool operator>=(DoubleDouble const& a, DoubleDouble const& b) {return b <= a;}
+
+    friend bool operator==(DoubleDouble const& a, DoubleDouble const& b) {
+      return a.hi == b.hi && a.lo == b.lo;
+    }
+
+    friend bool operator!=(DoubleDouble const& a, DoubleDouble const& b) {return !(a == b);}
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_DOUBLEDOUBLE_INCLUDED
@@ -0,0 +1,19 @@
+#ifndef MPIBROT_COMPUTE_ENGINE_INCLUDED
+#define MPIBROT_COMPUTE_ENGINE_INCLUDED
+
+
+namespace SimpleBrot {
+
+  // Iteration kernels that FillIterationBuffer can be asked to use
+  // Scalar is the portable fallback and works on any CPU and any type
+  enum class Engine {
+    Scalar,   // One std::complex orbit at a time
+    Sse2,     // 4 float or 2 double orbits per lane group
+    Avx2,     // 8 float or 4 double orbits per lane group
+    Avx512    // 16 float or 8 double orbits per lane group
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_ENGINE_INCLUDED
@@ -0,0 +1,110 @@
+#ifndef MPIBROT_COMPUTE_ESCAPE_INCLUDED
+#define MPIBROT_COMPUTE_ESCAPE_INCLUDED
+
+
+// Standard
+#include <algorithm>
+#include <cmath>
+
+
+namespace SimpleBrot {
+
+  // Final point of an escaped orbit, from which the smooth and distance
+  // output channels are derived without a second pass over the orbit
+  template<class T>
+  struct EscapeState {
+    bool trackDerivative = false;   // Set to also iterate dz/dc, 4 extra multiplies
+    T magnitudeSquared = T(0);      // |z|^2 at escape
+    T zr = T(0);                    // z at escape
+    T zi = T(0);
+    T dzr = T(0);                   // dz/dc at escape, if tracked
+    T dzi = T(0);
+  };
+
+
+  // Narrow a kernel value to double, for types without a conversion
+  template<class T>
+  inline double ToDouble(T const& x) {return x.ToDouble();}
+  inline double ToDouble(float const x) {return x;}
+  inline double ToDouble(double const x) {return x;}
+
+
+  // Continuous iteration count from an escaped orbit
+  // magnitudeSquared is |z|^2 at the first iteration past the bailout
+  // radius R. Normalising log|z| by log R makes the fraction run from 1 at
+  // |z| = R down to 0 at |z| = R^2, so counts join up across bands. Points
+  // that never escaped are returned as maxIterations.
+  inline float SmoothIterationCount(
+    unsigned const iterations,
+    double const magnitudeSquared,
+    unsigned const maxIterations,
+    unsigned const bailout) {
+
+    if(iterations >= maxIterations) {
+      return float(maxIterations);
+    }
+
+    double const logRadius = std::log(double(std::max(bailout, 2u)));
+    double const ratio = 0.5 * std::log(magnitudeSquared) / logRadius;
+    double const fraction = 1 - std::min(std::max(std::log2(ratio), 0.0), 1.0);
+
+    return float(iterations + fraction);
+  }
+
+
+  // Escape radius the distance estimate is evaluated at
+  // The estimate is only a bound for large |z|, at the usual bailout of 2 it
+  // can be out by orders of magnitude, so escaped orbits are continued past
+  // the bailout until they reach this radius first.
+  unsigned const DistanceRadius = 64;
+
+
+  // Exterior distance estimate from an escaped orbit and its derivative
+  // Returns |z| log|z| / |dz/dc|, half of Milnor's bound b, the distance
+  // from c to the set lies between b / 4 and b. Points that never escaped,
+  // or whose derivative overflowed, are returned as 0. Needs a floating
+  // point T, the derivative overflows fixed point for all but short orbits.
+  template<class T>
+  float DistanceEstimate(
+    unsigned const iterations,
+    unsigned const maxIterations,
+    EscapeState<T> const& escape,
+    T const& cr,
+    T const& ci) {
+
+    if(iterations >= maxIterations) {
+      return 0;
+    }
+
+    T zr = escape.zr;
+    T zi = escape.zi;
+    T dzr = escape.dzr;
+    T dzi = escape.dzi;
+    T const radiusSquared = T(DistanceRadius * DistanceRadius);
+
+    // |z| at least squares every step, so this takes a handful of steps
+    for(unsigned k = 0; k < 64 && zr * zr + zi * zi < radiusSquared; k++) {
+      T const tr = zr * dzr - zi * dzi;
+      T const ti = zr * dzi + zi * dzr;
+      dzr = tr + tr + T(1);
+      dzi = ti + ti;
+
+      T const nr = zr * zr - zi * zi + cr;
+      zi = (zr + zr) * zi + ci;
+      zr = nr;
+    }
+
+    double const magnitudeSquared = ToDouble(zr * zr + zi * zi);
+    double const derivativeSquared = ToDouble(dzr * dzr + dzi * dzi);
+
+    if(!(derivativeSquared > 0) || !std::isfinite(derivativeSquared) || !std::isfinite(magnitudeSquared)) {
+      return 0;
+    }
+
+    return float(0.5 * std::log(magnitudeSquared) * std::sqrt(magnitudeSquared / derivativeSquared));
+  }
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_ESCAPE_INCLUDED
@@ -0,0 +1,293 @@
+#ifndef MPIBROT_COMPUTE_FIXEDPOINT_INCLUDED
+#define MPIBROT_COMPUTE_FIXEDPOINT_INCLUDED
+
+
+// Internal
+#include "compute/QuadDouble.hpp"
+
+// Standard
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+
+namespace SimpleBrot {
+
+  // Fixed point two's complement number with Limbs 32 bit limbs
+  // The top limb is a signed integer part, the rest are 32 * (Limbs - 1)
+  // fractional bits. Storage is a plain array sized at compile time, so
+  // values never allocate and the limb loops unroll. Products keep the full
+  // double width result and truncate it toward zero, Square() produces the
+  // same bits as x * x from roughly half the limb products.
+  // Escape time orbits stay within a few times the bailout radius, so the
+  // 31 bit integer part never overflows in practice and isn't checked.
+  template<unsigned Limbs>
+  class FixedPoint {
+    static_assert(Limbs >= 2, "FixedPoint needs an integer and a fractional limb");
+
+  public:
+    static unsigned const FractionBits = 32 * (Limbs - 1);
+
+    // Least significant limb first
+    uint32_t limb[Limbs];
+
+    FixedPoint() : limb{} {}
+
+    // Exact for doubles within the integer range
+    FixedPoint(double const x) : limb{} {
+      double magnitude = std::fabs(x);
+      double const whole = std::floor(magnitude);
+      this->limb[Limbs - 1] = uint32_t(whole);
+      magnitude -= whole;
+
+      for(unsigned i = Limbs - 1; i-- > 0 && magnitude != 0;) {
+        magnitude = std::ldexp(magnitude, 32);
+        double const digit = std::floor(magnitude);
+        this->limb[i] = uint32_t(digit);
+        magnitude -= digit;
+      }
+
+      if(x < 0) {
+        this->Negate();
+      }
+    }
+
+    // Exact sum of the quad-double components, each is a double
+    FixedPoint(QuadDouble const& x) : FixedPoint(x.x[0]) {
+      *this += FixedPoint(x.x[1]);
+      *this += FixedPoint(x.x[2]);
+      *this += FixedPoint(x.x[3]);
+    }
+
+    // Parse a decimal string such as "-0.7436438870371587..."
+    // Deep zoom coordinates carry more digits than any double holds
+    static FixedPoint Parse(std::string const& decimal) {
+      bool const negative = !decimal.empty() && decimal[0] == '-';
+      std::string::size_type i = (negative || (!decimal.empty() && decimal[0] == '+')) ? 1 : 0;
+
+      FixedPoint whole;
+      for(; i < decimal.size() && decimal[i] != '.'; i++) {
+        if(decimal[i] < '0' || decimal[i] > '9') {
+          throw std::invalid_argument("invalid decimal '" + decimal + "'");
+        }
+        whole = whole * FixedPoint(10.0) + FixedPoint(double(decimal[i] - '0'));
+      }
+
+      // Digits after the point are folded in from the least significant end
+      FixedPoint fraction;
+      if(i < decimal.size()) {
+        for(std::string::size_type k = decimal.size(); k-- > i + 1;) {
+          if(decimal[k] < '0' || decimal[k] > '9') {
+            throw std::invalid_argument("invalid decimal '" + decimal + "'");
+          }
+          fraction.limb[Limbs - 1] += uint32_t(decimal[k] - '0');
+          fraction.DivideSmall(10);
+        }
+      }
+
+      FixedPoint result = whole + fraction;
+      return negative ? -result : result;
+    }
+
+    double ToDouble() const {
+      FixedPoint const magnitude = this->Negative() ? -*this : *this;
+      double result = 0;
+      for(unsigned i = 0; i < Limbs; i++) {
+        result += std::ldexp(double(magnitude.limb[i]), 32 * int(i) - int(FractionBits));
+      }
+      return this->Negative() ? -result : result;
+    }
+
+    bool Negative() const {
+      return (this->limb[Limbs - 1] & 0x80000000u) != 0;
+    }
+
+    friend FixedPoint operator+(FixedPoint const& a, FixedPoint const& b) {
+      FixedPoint result;
+      uint64_t carry = 0;
+      for(unsigned i = 0; i < Limbs; i++) {
+        uint64_t const sum = uint64_t(a.limb[i]) + b.limb[i] + carry;
+        result.limb[i] = uint32_t(sum);
+        carry = sum >> 32;
+      }
+      return result;
+    }
+
+    friend FixedPoint operator-(FixedPoint const& a, FixedPoint const& b) {
+      FixedPoint result;
+      uint64_t borrow = 0;
+      for(unsigned i = 0; i < Limbs; i++) {
+        uint64_t const difference = uint64_t(a.limb[i]) - b.limb[i] - borrow;
+        result.limb[i] = uint32_t(difference);
+        borrow = (difference >> 32) & 1;
+      }
+      return result;
+    }
+
+    friend FixedPoint operator-(FixedPoint const& a) {
+      FixedPoint result = a;
+      result.Negate();
+      return result;
+    }
+
+    friend FixedPoint operator*(FixedPoint const& a, FixedPoint const& b) {
+      bool const negative = a.Negative() != b.Negative();
+      FixedPoint const x = a.Negative() ? -a : a;
+      FixedPoint const y = b.Negative() ? -b : b;
+
+      uint32_t product[2 * Limbs] = {};
+      for(unsigned i = 0; i < Limbs; i++) {
+        uint64_t carry = 0;
+        for(unsigned j = 0; j < Limbs; j++) {
+          uint64_t const t = uint64_t(x.limb[i]) * y.limb[j] + product[i + j] + carry;
+          product[i + j] = uint32_t(t);
+          carry = t >> 32;
+        }
+        product[i + Limbs] = uint32_t(carry);
+      }
+
+      FixedPoint result = Truncate(product);
+      return negative ? -result : result;
+    }
+
+    // Cross terms a_i * a_j for i < j are computed once and doubled
+    friend FixedPoint Square(FixedPoint const& a) {
+      FixedPoint const x = a.Negative() ? -a : a;
+
+      uint32_t product[2 * Limbs] = {};
+      for(unsigned i = 0; i < Limbs; i++) {
+        uint64_t carry = 0;
+        for(unsigned j = i + 1; j < Limbs; j++) {
+          uint64_t const t = uint64_t(x.limb[i]) * x.limb[j] + product[i + j] + carry;
+          product[i + j] = uint32_t(t);
+          carry = t >> 32;
+        }
+        product[i + Limbs] = uint32_t(carry);
+      }
+
+      uint32_t top = 0;
+      for(unsigned k = 0; k < 2 * Limbs; k++) {
+        uint32_t const next = product[k] >> 31;
+        product[k] = (product[k] << 1) | top;
+        top = next;
+      }
+
+      uint64_t carry = 0;
+      for(unsigned i = 0; i < Limbs; i++) {
+        uint64_t const d = uint64_t(x.limb[i]) * x.limb[i];
+        uint64_t const lo = uint64_t(product[2 * i]) + uint32_t(d) + carry;
+        product[2 * i] = uint32_t(lo);
+        uint64_t const hi = uint64_t(product[2 * i + 1]) + (d >> 32) + (lo >> 32);
+        product[2 * i + 1] = uint32_t(hi);
+        carry = hi >> 32;
+      }
+
+      return Truncate(product);
+    }
+
+    // Restoring long division, only used for setting up pixel steps
+    friend FixedPoint operator/(FixedPoint const& a, FixedPoint const& b) {
+      bool const negative = a.Negative() != b.Negative();
+      FixedPoint const x = a.Negative() ? -a : a;
+      FixedPoint const y = b.Negative() ? -b : b;
+
+      // Numerator scaled up by the fractional bits
+      uint32_t numerator[2 * Limbs] = {};
+      for(unsigned i = 0; i < Limbs; i++) {
+        numerator[i + Limbs - 1] = x.limb[i];
+      }
+
+      // The remainder stays below 2 * |b|, which fits as an unsigned value
+      FixedPoint quotient;
+      FixedPoint remainder;
+      for(unsigned bit = 32 * 2 * Limbs; bit-- > 0;) {
+        remainder = remainder + remainder;
+        remainder.limb[0] |= (numerator[bit / 32] >> (bit % 32)) & 1;
+
+        if(!UnsignedLess(remainder, y)) {
+          remainder = remainder - y;
+          if(bit < 32 * Limbs) {
+            quotient.limb[bit / 32] |= 1u << (bit % 32);
+          }
+        }
+      }
+
+      return negative ? -quotient : quotient;
+    }
+
+    FixedPoint& operator+=(FixedPoint const& b) {return *this = *this + b;}
+    FixedPoint& operator-=(FixedPoint const& b) {return *this = *this - b;}
+    FixedPoint& operator*=(FixedPoint const& b) {return *this = *this * b;}
+    FixedPoint& operator/=(FixedPoint const& b) {return *this = *this / b;}
+
+    friend bool operator<(FixedPoint const& a, FixedPoint const& b) {
+      if(a.limb[Limbs - 1] != b.limb[Limbs - 1]) {
+        return int32_t(a.limb[Limbs - 1]) < int32_t(b.limb[Limbs - 1]);
+      }
+      for(unsigned i = Limbs - 1; i-- > 0;) {
+        if(a.limb[i] != b.limb[i]) {
+          return a.limb[i] < b.limb[i];
+        }
+      }
+      return false;
+    }
+
+    friend bool operator==(FixedPoint const& a, FixedPoint const& b) {
+      for(unsigned i = 0; i < Limbs; i++) {
+        if(a.limb[i] != b.limb[i]) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    friend bool operator<=(FixedPoint const& a, FixedPoint const& b) {return !(b < a);}
+    friend bool operator>(FixedPoint const& a, FixedPoint const& b) {return b < a;}
+    friend bool operator>=(FixedPoint const& a, FixedPoint const& b) {return !(a < b);}
+    friend bool operator!=(FixedPoint const& a, FixedPoint const& b) {return !(a == b);}
+
+  private:
+    // Two's complement negation in place
+    void Negate() {
+      uint64_t carry = 1;
+      for(unsigned i = 0; i < Limbs; i++) {
+        uint64_t const sum = uint64_t(~this->limb[i]) + carry;
+        this->limb[i] = uint32_t(sum);
+        carry = sum >> 32;
+      }
+    }
+
+    // Divide a non negative value by a small integer in place
+    void DivideSmall(uint32_t const divisor) {
+      uint64_t remainder = 0;
+      for(unsigned i = Limbs; i-- > 0;) {
+        uint64_t const current = (remainder << 32) | this->limb[i];
+        this->limb[i] = uint32_t(current / divisor);
+        remainder = current % divisor;
+      }
+    }
+
+    static bool UnsignedLess(FixedPoint const& a, FixedPoint const& b) {
+      for(unsigned i = Limbs; i-- > 0;) {
+        if(a.limb[i] != b.limb[i]) {
+          return a.limb[i] < b.limb[i];
+        }
+      }
+      return false;
+    }
+
+    // Drop the extra fractional limbs of a double width product
+    static FixedPoint Truncate(uint32_t const (&product)[2 * Limbs]) {
+      FixedPoint result;
+      for(unsigned i = 0; i < Limbs; i++) {
+        result.limb[i] = product[i + Limbs - 1];
+      }
+      return result;
+    }
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_FIXEDPOINT_INCLUDED
@@ -0,0 +1,20 @@
+#ifndef MPIBROT_COMPUTE_KERNELSTATS_INCLUDED
+#define MPIBROT_COMPUTE_KERNELSTATS_INCLUDED
+
+
+namespace SimpleBrot {
+
+  // Counters the iteration kernels can optionally report into
+  // Kernels only ever add to these, so one instance can span many calls
+  struct KernelStats {
+    unsigned long long iteratedPixels = 0;          // Pixels run through a kernel
+    unsigned long long filledPixels = 0;            // Pixels inferred without iterating
+    unsigned long long interiorShortCircuits = 0;   // Cardioid/bulb hits
+    unsigned long long periodicExits = 0;           // Orbits caught in a cycle
+    unsigned long long extraSamples = 0;            // Supersamples beyond one per pixel
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_KERNELSTATS_INCLUDED
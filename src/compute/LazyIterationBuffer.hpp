@@ -0,0 +1,100 @@
+#ifndef MPIBROT_COMPUTE_LAZYITERATIONBUFFER_INCLUDED
+#define MPIBROT_COMPUTE_LAZYITERATIONBUFFER_INCLUDED
+
+
+// Internal
+#include "compute/SimpleBrot.hpp"
+#include "compute/KernelStats.hpp"
+#include "util/Buffer2D.hpp"
+
+// Standard
+#include <complex>
+#include <vector>
+
+
+namespace SimpleBrot {
+
+  // Iteration buffer whose pixels are computed on first access
+  // Used by fill strategies that only iterate some pixels and infer the
+  // rest. Pixels are evaluated exactly as FillIterationBuffer evaluates them,
+  // so every iterated pixel is identical to a brute force render.
+  template<class T>
+  class LazyIterationBuffer {
+  private:
+
+    Buffer2D<unsigned>& data;
+    std::vector<bool> done;
+
+    T const re0;
+    T const im0;
+    T const rStep;
+    T const iStep;
+    T const tolerance;
+
+    unsigned const maxIterations;
+    unsigned const bailout;
+
+    KernelStats* stats;
+
+  public:
+
+    LazyIterationBuffer(
+      Buffer2D<unsigned>& data,
+      std::complex<T> const start,
+      std::complex<T> const end,
+      unsigned const maxIterations,
+      unsigned const bailout,
+      KernelStats* stats) :
+      data(data),
+      done(data.Width() * data.Height(), false),
+      re0(start.real()),
+      im0(start.imag()),
+      rStep((end.real() - start.real()) / data.Width()),
+      iStep((end.imag() - start.imag()) / data.Height()),
+      tolerance(PeriodicityTolerance(rStep, iStep)),
+      maxIterations(maxIterations),
+      bailout(bailout),
+      stats(stats) {}
+
+    unsigned Width() {return this->data.Width();}
+    unsigned Height() {return this->data.Height();}
+
+    // Whether a pixel has been iterated or filled
+    bool Done(unsigned const x, unsigned const y) const {
+      return this->done[y * this->data.Width() + x];
+    }
+
+    // Iterate a pixel unless that has already happened
+    unsigned Evaluate(unsigned const x, unsigned const y) {
+      if(!this->Done(x, y)) {
+        std::complex<T> c = std::complex<T>(
+          this->re0 + (this->rStep * x),
+          this->im0 + (this->iStep * y));
+
+        this->data.Get(x, y) = ComputeIterationCount(
+          c, this->maxIterations, this->bailout, this->tolerance, this->stats);
+        this->done[y * this->data.Width() + x] = true;
+
+        if(this->stats != nullptr) {
+          this->stats->iteratedPixels++;
+        }
+      }
+
+      return this->data.Get(x, y);
+    }
+
+    // Set a pixel without iterating it
+    void Fill(unsigned const x, unsigned const y, unsigned const iterationCount) {
+      this->data.Get(x, y) = iterationCount;
+      this->done[y * this->data.Width() + x] = true;
+
+      if(this->stats != nullptr) {
+        this->stats->filledPixels++;
+      }
+    }
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_LAZYITERATIONBUFFER_INCLUDED
@@ -0,0 +1,120 @@
+#ifndef MPIBROT_COMPUTE_MARIANISILVER_INCLUDED
+#define MPIBROT_COMPUTE_MARIANISILVER_INCLUDED
+
+
+// Internal
+#include "compute/LazyIterationBuffer.hpp"
+#include "compute/KernelStats.hpp"
+#include "util/Buffer2D.hpp"
+
+// Standard
+#include <complex>
+
+
+namespace SimpleBrot {
+
+  // Mariani-Silver rectangle subdivision
+  // The border of a rectangle is iterated, if every border pixel has the same
+  // count the interior is filled with it, otherwise the rectangle is split in
+  // two along its longer side and each half is processed the same way. Since
+  // the set and its escape time bands are connected, a uniform border can't
+  // enclose anything else.
+  template<class T>
+  class MarianiSilver {
+  private:
+
+    LazyIterationBuffer<T> buffer;
+    unsigned const minSize;
+
+
+    // Process the inclusive rectangle [x0, x1] x [y0, y1]
+    void Subdivide(unsigned const x0, unsigned const y0, unsigned const x1, unsigned const y1) {
+
+      // Walk the border, noting whether it is uniform
+      unsigned const first = this->buffer.Evaluate(x0, y0);
+      bool uniform = true;
+
+      for(unsigned x = x0; x <= x1; x++) {
+        uniform &= (this->buffer.Evaluate(x, y0) == first);
+        uniform &= (this->buffer.Evaluate(x, y1) == first);
+      }
+      for(unsigned y = y0; y <= y1; y++) {
+        uniform &= (this->buffer.Evaluate(x0, y) == first);
+        uniform &= (this->buffer.Evaluate(x1, y) == first);
+      }
+
+      // Nothing left inside
+      if(x1 - x0 < 2 || y1 - y0 < 2) {
+        return;
+      }
+
+      if(uniform) {
+        for(unsigned y = y0 + 1; y < y1; y++) {
+          for(unsigned x = x0 + 1; x < x1; x++) {
+            this->buffer.Fill(x, y, first);
+          }
+        }
+        return;
+      }
+
+      // Small rectangles aren't worth splitting any further
+      if(x1 - x0 <= this->minSize && y1 - y0 <= this->minSize) {
+        for(unsigned y = y0 + 1; y < y1; y++) {
+          for(unsigned x = x0 + 1; x < x1; x++) {
+            this->buffer.Evaluate(x, y);
+          }
+        }
+        return;
+      }
+
+      // Split along the longer side, halves share the dividing line
+      if(x1 - x0 >= y1 - y0) {
+        unsigned const xm = x0 + (x1 - x0) / 2;
+        this->Subdivide(x0, y0, xm, y1);
+        this->Subdivide(xm, y0, x1, y1);
+      } else {
+        unsigned const ym = y0 + (y1 - y0) / 2;
+        this->Subdivide(x0, y0, x1, ym);
+        this->Subdivide(x0, ym, x1, y1);
+      }
+    }
+
+  public:
+
+    MarianiSilver(
+      Buffer2D<unsigned>& data,
+      std::complex<T> const start,
+      std::complex<T> const end,
+      unsigned const maxIterations,
+      unsigned const bailout,
+      unsigned const minSize,
+      KernelStats* stats) :
+      buffer(data, start, end, maxIterations, bailout, stats),
+      minSize(minSize) {}
+
+    void Fill() {
+      if(this->buffer.Width() > 0 && this->buffer.Height() > 0) {
+        this->Subdivide(0, 0, this->buffer.Width() - 1, this->buffer.Height() - 1);
+      }
+    }
+  };
+
+
+  // Generate a 2d buffer full of iteration counts by rectangle subdivision
+  template<class T>
+  void FillIterationBufferMarianiSilver(
+    Buffer2D<unsigned>& data,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    KernelStats* stats = nullptr,
+    unsigned const minSize = 8) {
+
+    MarianiSilver<T>(data, start, end, maxIterations, bailout, minSize, stats).Fill();
+  }
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_MARIANISILVER_INCLUDED
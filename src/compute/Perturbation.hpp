@@ -0,0 +1,214 @@
+#ifndef MPIBROT_COMPUTE_PERTURBATION_INCLUDED
+#define MPIBROT_COMPUTE_PERTURBATION_INCLUDED
+
+
+// Internal
+#include "compute/AdaptiveSupersample.hpp"
+#include "compute/Escape.hpp"
+#include "compute/KernelStats.hpp"
+#include "compute/ReferenceOrbit.hpp"
+#include "compute/SeriesApproximation.hpp"
+#include "util/Buffer2D.hpp"
+
+// Standard
+#include <complex>
+#include <vector>
+
+
+namespace SimpleBrot {
+
+  // Iterate a pixel as an offset dc from the reference orbit's c
+  // The delta obeys dz' = (2Z + dz)dz + dc and only needs double precision.
+  // When the full orbit Z + dz gets closer to zero than the delta itself the
+  // delta has lost precision relative to the reference (a glitch). Rebasing
+  // restarts the reference from Z_0 with dz = Z + dz, which also lets pixels
+  // carry on past the end of a reference orbit that escaped early.
+  // Iteration starts from dz after startIteration steps, which lets a series
+  // approximation skip the early part of the orbit. escapeMagnitudeSquared,
+  // if given, receives |Z + dz|^2 at the final iteration.
+  inline unsigned ComputePerturbedIterationCount(
+    ReferenceOrbit const& orbit,
+    std::complex<double> const dc,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    unsigned* rebaseCount = nullptr,
+    std::complex<double> const dz = 0,
+    unsigned const startIteration = 0,
+    double* escapeMagnitudeSquared = nullptr) {
+
+    double const bailoutSquared = double(bailout) * double(bailout);
+    double dzr = dz.real();
+    double dzi = dz.imag();
+    unsigned m = startIteration;
+    unsigned iterationCount = startIteration;
+    double magnitudeSquared = 0;
+
+    while(iterationCount < maxIterations) {
+      std::complex<double> const& Z = orbit.Get(m);
+
+      // dz = (2Z + dz) * dz + dc
+      double const tr = 2 * Z.real() + dzr;
+      double const ti = 2 * Z.imag() + dzi;
+      double const nr = tr * dzr - ti * dzi + dc.real();
+      double const ni = tr * dzi + ti * dzr + dc.imag();
+      dzr = nr;
+      dzi = ni;
+
+      m++;
+      iterationCount++;
+
+      std::complex<double> const& Zm = orbit.Get(m);
+      double const zr = Zm.real() + dzr;
+      double const zi = Zm.imag() + dzi;
+      magnitudeSquared = zr * zr + zi * zi;
+
+      if(magnitudeSquared >= bailoutSquared) {
+        break;
+      }
+
+      if(magnitudeSquared < dzr * dzr + dzi * dzi || m + 1 >= orbit.Length()) {
+        dzr = zr;
+        dzi = zi;
+        m = 0;
+
+        if(rebaseCount != nullptr) {
+          (*rebaseCount)++;
+        }
+      }
+    }
+
+    if(escapeMagnitudeSquared != nullptr) {
+      *escapeMagnitudeSquared = magnitudeSquared;
+    }
+
+    return iterationCount;
+  }
+
+
+  // Continuous iteration count of a perturbed pixel, see SmoothIterationCount
+  inline float ComputePerturbedSmoothIterationCount(
+    ReferenceOrbit const& orbit,
+    std::complex<double> const dc,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    SeriesApproximation const* series = nullptr,
+    KernelStats* stats = nullptr) {
+
+    double magnitudeSquared = 0;
+    unsigned iterations = 0;
+
+    if(series != nullptr) {
+      iterations = ComputePerturbedIterationCount(
+        orbit, dc, maxIterations, bailout, nullptr,
+        series->Delta(dc), series->Skip(), &magnitudeSquared);
+    } else {
+      iterations = ComputePerturbedIterationCount(
+        orbit, dc, maxIterations, bailout, nullptr, 0, 0, &magnitudeSquared);
+    }
+
+    if(stats != nullptr) {
+      stats->iteratedPixels++;
+    }
+
+    return SmoothIterationCount(iterations, magnitudeSquared, maxIterations, bailout);
+  }
+
+
+  // Fill a buffer with perturbed iteration counts
+  // deltaStart and deltaEnd are the corners of the view relative to the
+  // reference point, so they stay representable at any zoom depth.
+  // With a series approximation every pixel starts at series->Skip().
+  inline void FillIterationBufferPerturbed(
+    Buffer2D<unsigned>& data,
+    ReferenceOrbit const& orbit,
+    std::complex<double> const deltaStart,
+    std::complex<double> const deltaEnd,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    SeriesApproximation const* series = nullptr,
+    unsigned* rebaseCount = nullptr) {
+
+    double rStep = (deltaEnd.real() - deltaStart.real()) / data.Width();
+    double iStep = (deltaEnd.imag() - deltaStart.imag()) / data.Height();
+
+    for(unsigned i = 0; i < data.Height(); i++) {
+      for(unsigned j = 0; j < data.Width(); j++) {
+
+        std::complex<double> dc = std::complex<double>(
+          deltaStart.real() + (rStep * j),
+          deltaStart.imag() + (iStep * i));
+
+        if(series != nullptr) {
+          data.Get(j, i) = ComputePerturbedIterationCount(
+            orbit, dc, maxIterations, bailout, rebaseCount,
+            series->Delta(dc), series->Skip());
+        } else {
+          data.Get(j, i) = ComputePerturbedIterationCount(
+            orbit, dc, maxIterations, bailout, rebaseCount);
+        }
+      }
+    }
+  }
+
+
+
+  // Fill a buffer with perturbed continuous iteration counts
+  // Pixel (j, i) sits at deltaStart + (originX + j, originY + i) * step
+  // relative to the reference, so the tiles of a frame can share one grid
+  // and come out exactly as the whole frame would.
+  inline void FillSmoothIterationBufferPerturbed(
+    Buffer2D<float>& data,
+    ReferenceOrbit const& orbit,
+    std::complex<double> const deltaStart,
+    std::complex<double> const step,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    SeriesApproximation const* series = nullptr,
+    KernelStats* stats = nullptr,
+    unsigned const originX = 0,
+    unsigned const originY = 0) {
+
+    for(unsigned i = 0; i < data.Height(); i++) {
+      for(unsigned j = 0; j < data.Width(); j++) {
+
+        std::complex<double> dc = std::complex<double>(
+          deltaStart.real() + (step.real() * (originX + j)),
+          deltaStart.imag() + (step.imag() * (originY + i)));
+
+        data.Get(j, i) = ComputePerturbedSmoothIterationCount(
+          orbit, dc, maxIterations, bailout, series, stats);
+      }
+    }
+  }
+
+
+  // Antialias perturbed continuous counts at the given edges
+  // The perturbed counterpart of SupersampleEdges, on the grid of
+  // FillSmoothIterationBufferPerturbed
+  inline void SupersampleEdgesPerturbed(
+    Buffer2D<float>& data,
+    ReferenceOrbit const& orbit,
+    std::complex<double> const deltaStart,
+    std::complex<double> const step,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    unsigned const scale,
+    std::vector<bool> const& edge,
+    SeriesApproximation const* series = nullptr,
+    KernelStats* stats = nullptr,
+    unsigned const originX = 0,
+    unsigned const originY = 0) {
+
+    SupersampleEdgesWith(data, edge, scale, stats, originX, originY,
+      [&](double const x, double const y) {
+        std::complex<double> dc = std::complex<double>(
+          deltaStart.real() + (step.real() * x),
+          deltaStart.imag() + (step.imag() * y));
+        return ComputePerturbedSmoothIterationCount(orbit, dc, maxIterations, bailout, series, stats);
+      });
+  }
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_PERTURBATION_INCLUDED
@@ -0,0 +1,156 @@
+#ifndef MPIBROT_COMPUTE_PRECISION_INCLUDED
+#define MPIBROT_COMPUTE_PRECISION_INCLUDED
+
+
+// Internal
+#include "compute/DoubleDouble.hpp"
+#include "compute/Engine.hpp"
+#include "compute/FixedPoint.hpp"
+#include "compute/KernelStats.hpp"
+#include "compute/QuadDouble.hpp"
+#include "compute/SimpleBrot.hpp"
+#include "util/Buffer2D.hpp"
+
+// Standard
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <string>
+
+
+namespace SimpleBrot {
+
+  // Value types the iteration kernels can be instantiated with
+  enum class Precision {
+    Float,          // 24 bit mantissa, vectorised
+    Double,         // 53 bit mantissa, vectorised
+    DoubleDouble,   // 106 bit mantissa, vectorised
+    QuadDouble,     // 212 bit mantissa, scalar only, tiles perturb instead
+    FixedPoint      // 480 fractional bits, scalar only, tiles perturb instead
+  };
+
+
+  // Fixed point type behind Precision::FixedPoint
+  // Only direct iteration through FillIterationBuffer uses it. Tiles at this
+  // depth perturb around a reference orbit, and a DeepFixedPoint orbit is
+  // no faster than the 512 bit binary float one ReferenceOrbit picks.
+  typedef SimpleBrot::FixedPoint<16> DeepFixedPoint;
+
+
+  // Mantissa bits carried by a precision
+  inline unsigned MantissaBits(Precision const precision) {
+    switch(precision) {
+      case Precision::Float: return 24;
+      case Precision::Double: return 53;
+      case Precision::DoubleDouble: return 106;
+      case Precision::QuadDouble: return 212;
+      case Precision::FixedPoint: return DeepFixedPoint::FractionBits;
+    }
+    return 0;
+  }
+
+
+  // Human readable precision name
+  inline std::string PrecisionName(Precision const precision) {
+    switch(precision) {
+      case Precision::Float: return "float";
+      case Precision::Double: return "double";
+      case Precision::DoubleDouble: return "double-double";
+      case Precision::QuadDouble: return "quad-double";
+      case Precision::FixedPoint: return "fixed-point";
+    }
+    return "unknown";
+  }
+
+
+  // Cheapest precision that resolves pixels this far apart
+  // magnitude bounds the coordinates and orbit values, the bits above the
+  // pixel spacing are the ones a coordinate needs, 12 guard bits cover
+  // rounding error amplified over the orbit. Past fixed point the deepest
+  // available precision is returned and pixels will start to block up.
+  inline Precision SelectPrecision(double const pixelSpacing, double const magnitude = 2.0) {
+    double const needed = std::log2(std::max(magnitude, 2.0) / pixelSpacing) + 12;
+
+    for(Precision const precision : {Precision::Float, Precision::Double, Precision::DoubleDouble, Precision::QuadDouble}) {
+      if(needed <= MantissaBits(precision)) {
+        return precision;
+      }
+    }
+    return Precision::FixedPoint;
+  }
+
+
+  // Narrow a quad-double coordinate to a kernel value type
+  template<class T>
+  inline T NarrowTo(QuadDouble const& x) {
+    return T(x);
+  }
+
+  template<>
+  inline float NarrowTo<float>(QuadDouble const& x) {
+    return float(x.ToDouble());
+  }
+
+  template<>
+  inline double NarrowTo<double>(QuadDouble const& x) {
+    return x.ToDouble();
+  }
+
+  template<>
+  inline DoubleDouble NarrowTo<DoubleDouble>(QuadDouble const& x) {
+    return DoubleDouble(x.x[0], x.x[1]);
+  }
+
+
+  // Generate a 2d buffer of iteration counts at a given precision
+  // The view is given in quad-double and narrowed to the chosen type
+  template<class T>
+  void FillIterationBufferAt(
+    Buffer2D<unsigned>& data,
+    std::complex<QuadDouble> const& start,
+    std::complex<QuadDouble> const& end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    Engine const engine,
+    KernelStats* stats) {
+
+    FillIterationBuffer(
+      data,
+      std::complex<T>(NarrowTo<T>(start.real()), NarrowTo<T>(start.imag())),
+      std::complex<T>(NarrowTo<T>(end.real()), NarrowTo<T>(end.imag())),
+      maxIterations, bailout, engine, stats);
+  }
+
+  inline void FillIterationBuffer(
+    Buffer2D<unsigned>& data,
+    std::complex<QuadDouble> const& start,
+    std::complex<QuadDouble> const& end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    Precision const precision,
+    Engine const engine = Engine::Scalar,
+    KernelStats* stats = nullptr) {
+
+    switch(precision) {
+      case Precision::Float:
+        FillIterationBufferAt<float>(data, start, end, maxIterations, bailout, engine, stats);
+        break;
+      case Precision::Double:
+        FillIterationBufferAt<double>(data, start, end, maxIterations, bailout, engine, stats);
+        break;
+      case Precision::DoubleDouble:
+        FillIterationBufferAt<DoubleDouble>(data, start, end, maxIterations, bailout, engine, stats);
+        break;
+      case Precision::QuadDouble:
+        FillIterationBufferAt<QuadDouble>(data, start, end, maxIterations, bailout, engine, stats);
+        break;
+      case Precision::FixedPoint:
+        FillIterationBufferAt<DeepFixedPoint>(data, start, end, maxIterations, bailout, engine, stats);
+        break;
+    }
+  }
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_PRECISION_INCLUDED
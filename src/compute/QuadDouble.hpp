@@ -0,0 +1,208 @@
+#ifndef MPIBROT_COMPUTE_QUADDOUBLE_INCLUDED
+#define MPIBROT_COMPUTE_QUADDOUBLE_INCLUDED
+
+
+// Internal
+#include "compute/DoubleDouble.hpp"
+
+
+namespace SimpleBrot {
+
+  // Quad-double value type, an unevaluated sum of four doubles giving ~212
+  // bits of mantissa, usable as T in the SimpleBrot templates
+  // Addition and multiplication are the "sloppy" variants of Hida, Li and
+  // Bailey, accurate relative to the operand magnitudes, which is all the
+  // escape time iteration needs and roughly half the cost of the IEEE style
+  // versions. Error free transforms are shared with DoubleDouble.
+  class QuadDouble {
+  private:
+    typedef DoubleDoubleArithmetic<ScalarDoubleLane> Eft;
+
+    // a + b + c -> a + b + c with a the rounded sum
+    static inline void ThreeSum(double& a, double& b, double& c) {
+      Eft::Value const t = Eft::TwoSum(a, b);
+      Eft::Value const u = Eft::TwoSum(c, t.hi);
+      Eft::Value const v = Eft::TwoSum(t.lo, u.lo);
+      a = u.hi;
+      b = v.hi;
+      c = v.lo;
+    }
+
+    // a + b + c -> a + b, dropping the lowest order term
+    static inline void ThreeSum2(double& a, double& b, double const c) {
+      Eft::Value const t = Eft::TwoSum(a, b);
+      Eft::Value const u = Eft::TwoSum(c, t.hi);
+      a = u.hi;
+      b = t.lo + u.lo;
+    }
+
+    static inline double QuickTwoSum(double const a, double const b, double& e) {
+      Eft::Value const s = Eft::QuickTwoSum(a, b);
+      e = s.lo;
+      return s.hi;
+    }
+
+    static inline double TwoSum(double const a, double const b, double& e) {
+      Eft::Value const s = Eft::TwoSum(a, b);
+      e = s.lo;
+      return s.hi;
+    }
+
+    static inline double TwoProd(double const a, double const b, double& e) {
+      Eft::Value const p = Eft::TwoProd(a, b);
+      e = p.lo;
+      return p.hi;
+    }
+
+    // Renormalise five overlapping terms into four non overlapping ones
+    static QuadDouble Renormalise(double c0, double c1, double c2, double c3, double c4) {
+      double s0 = QuickTwoSum(c3, c4, c4);
+      s0 = QuickTwoSum(c2, s0, c3);
+      s0 = QuickTwoSum(c1, s0, c2);
+      c0 = QuickTwoSum(c0, s0, c1);
+
+      s0 = c0;
+      double s1 = c1;
+      double s2 = 0;
+      double s3 = 0;
+
+      if(s1 != 0) {
+        s1 = QuickTwoSum(s1, c2, s2);
+        if(s2 != 0) {
+          s2 = QuickTwoSum(s2, c3, s3);
+          if(s3 != 0) {
+            s3 += c4;
+          } else {
+            s2 = QuickTwoSum(s2, c4, s3);
+          }
+        } else {
+          s1 = QuickTwoSum(s1, c3, s2);
+          if(s2 != 0) {
+            s2 = QuickTwoSum(s2, c4, s3);
+          } else {
+            s1 = QuickTwoSum(s1, c4, s2);
+          }
+        }
+      } else {
+        s0 = QuickTwoSum(s0, c2, s1);
+        if(s1 != 0) {
+          s1 = QuickTwoSum(s1, c3, s2);
+          if(s2 != 0) {
+            s2 = QuickTwoSum(s2, c4, s3);
+          } else {
+            s1 = QuickTwoSum(s1, c4, s2);
+          }
+        } else {
+          s0 = QuickTwoSum(s0, c3, s1);
+          if(s1 != 0) {
+            s1 = QuickTwoSum(s1, c4, s2);
+          } else {
+            s0 = QuickTwoSum(s0, c4, s1);
+          }
+        }
+      }
+
+      return QuadDouble(s0, s1, s2, s3);
+    }
+
+  public:
+    double x[4];
+
+    QuadDouble(double const v = 0) : x{v, 0, 0, 0} {}
+    QuadDouble(DoubleDouble const& v) : x{v.hi, v.lo, 0, 0} {}
+    QuadDouble(double const x0, double const x1, double const x2, double const x3) : x{x0, x1, x2, x3} {}
+
+    double ToDouble() const {return this->x[0] + (this->x[1] + (this->x[2] + this->x[3]));}
+
+    friend QuadDouble operator+(QuadDouble const& a, QuadDouble const& b) {
+      double t0, t1, t2, t3;
+      double s0 = TwoSum(a.x[0], b.x[0], t0);
+      double s1 = TwoSum(a.x[1], b.x[1], t1);
+      double s2 = TwoSum(a.x[2], b.x[2], t2);
+      double s3 = TwoSum(a.x[3], b.x[3], t3);
+
+      s1 = TwoSum(s1, t0, t0);
+      ThreeSum(s2, t0, t1);
+      ThreeSum2(s3, t0, t2);
+      t0 = t0 + t1 + t3;
+
+      return Renormalise(s0, s1, s2, s3, t0);
+    }
+
+    friend QuadDouble operator-(QuadDouble const& a) {
+      return QuadDouble(-a.x[0], -a.x[1], -a.x[2], -a.x[3]);
+    }
+
+    friend QuadDouble operator-(QuadDouble const& a, QuadDouble const& b) {
+      return a + (-b);
+    }
+
+    friend QuadDouble operator*(QuadDouble const& a, QuadDouble const& b) {
+      double q0, q1, q2, q3, q4, q5;
+      double const p0 = TwoProd(a.x[0], b.x[0], q0);
+      double p1 = TwoProd(a.x[0], b.x[1], q1);
+      double p2 = TwoProd(a.x[1], b.x[0], q2);
+      double p3 = TwoProd(a.x[0], b.x[2], q3);
+      double p4 = TwoProd(a.x[1], b.x[1], q4);
+      double p5 = TwoProd(a.x[2], b.x[0], q5);
+
+      // O(eps) terms
+      ThreeSum(p1, p2, q0);
+
+      // O(eps^2) terms
+      ThreeSum(p2, q1, q2);
+      ThreeSum(p3, p4, p5);
+
+      double t0, t1;
+      double s0 = TwoSum(p2, p3, t0);
+      double s1 = TwoSum(q1, p4, t1);
+      double s2 = q2 + p5;
+      s1 = TwoSum(s1, t0, t0);
+      s2 += (t0 + t1);
+
+      // O(eps^3) terms
+      s1 += a.x[0] * b.x[3] + a.x[1] * b.x[2] + a.x[2] * b.x[1] + a.x[3] * b.x[0] + q0 + q3 + q4 + q5;
+
+      return Renormalise(p0, p1, s0, s1, s2);
+    }
+
+    // Long division, only used for setting up pixel steps
+    friend QuadDouble operator/(QuadDouble const& a, QuadDouble const& b) {
+      double q[5];
+      QuadDouble r = a;
+      for(unsigned i = 0; i < 5; i++) {
+        q[i] = r.x[0] / b.x[0];
+        r = r - b * QuadDouble(q[i]);
+      }
+      return Renormalise(q[0], q[1], q[2], q[3], q[4]);
+    }
+
+    QuadDouble& operator+=(QuadDouble const& b) {return *this = *this + b;}
+    QuadDouble& operator-=(QuadDouble const& b) {return *this = *this - b;}
+    QuadDouble& operator*=(QuadDouble const& b) {return *this = *this * b;}
+    QuadDouble& operator/=(QuadDouble const& b) {return *this = *this / b;}
+
+    // Normalised values compare component by component
+    friend bool operator<(QuadDouble const& a, QuadDouble const& b) {
+      for(unsigned i = 0; i < 4; i++) {
+        if(a.x[i] != b.x[i]) {
+          return a.x[i] < b.x[i];
+        }
+      }
+      return false;
+    }
+
+    friend bool operator==(QuadDouble const& a, QuadDouble const& b) {
+      return a.x[0] == b.x[0] && a.x[1] == b.x[1] && a.x[2] == b.x[2] && a.x[3] == b.x[3];
+    }
+
+    friend bool operator<=(QuadDouble const& a, QuadDouble const& b) {return !(b < a);}
+    friend bool operator>(QuadDouble const& a, QuadDouble const& b) {return b < a;}
+    friend bool operator>=(QuadDouble const& a, QuadDouble const& b) {return !(a < b);}
+    friend bool operator!=(QuadDouble const& a, QuadDouble const& b) {return !(a == b);}
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_QUADDOUBLE_INCLUDED
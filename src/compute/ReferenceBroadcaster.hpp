@@ -0,0 +1,140 @@
+#ifndef MPIBROT_COMPUTE_REFERENCEBROADCASTER_INCLUDED
+#define MPIBROT_COMPUTE_REFERENCEBROADCASTER_INCLUDED
+
+
+// Internal
+#include "compute/ReferenceCache.hpp"
+#include "compute/Tile.hpp"
+#include "mpi/comm.hpp"
+#include "mpi/error.hpp"
+#include "util/Queue.hpp"
+
+// External
+#include "mpi.h"
+
+// Standard
+#include <memory>
+#include <thread>
+
+
+namespace SimpleBrot {
+
+  // Builds frame references on the head rank and broadcasts them to the
+  // reference caches of every rank, the head's included
+  // The multiprecision reference orbit of a frame is computed once rather
+  // than by every tile on every rank. Broadcasts go out in the order frames
+  // were published, on a communicator of their own, from one thread per rank.
+  class ReferenceBroadcaster {
+  private:
+    enum class Kind : int {Publish, Forget, Stop};
+
+    typedef struct {
+      Kind kind;
+      unsigned frame;
+      Tile tile;
+    }
+    Message;
+
+    typedef struct {
+      Kind kind;
+      unsigned frame;
+    }
+    Header;
+
+    std::shared_ptr<util::Queue<Message>> m_messages;
+    std::shared_ptr<ReferenceCache> m_cache;
+
+    MPI_Comm m_comm;
+
+    int const m_head_node;
+
+    std::thread m_broadcast_thread;
+
+    void broadcastThreadMain() {
+      bool const head = mpi::comm::rank(m_comm) == m_head_node;
+
+      while(1) {
+        boost::optional<Message> message;
+        Header header = {Kind::Stop, 0};
+
+        if(head) {
+          message = m_messages->dequeue();
+          if(message) {
+            header = {message->kind, message->frame};
+          }
+        }
+
+        std::shared_ptr<FrameReference> reference;
+        if(head && header.kind == Kind::Publish) {
+          reference = std::make_shared<FrameReference>(message->tile);
+        }
+
+        mpi::error::check(MPI_Bcast(&header, sizeof(Header), MPI_BYTE, m_head_node, m_comm));
+
+        if(header.kind == Kind::Stop) {
+          break;
+        }
+
+        if(header.kind == Kind::Forget) {
+          m_cache->erase(header.frame);
+          continue;
+        }
+
+        if(!head) {
+          reference = std::make_shared<FrameReference>();
+        }
+
+        reference->mpiBroadcast(m_head_node, m_comm);
+        m_cache->insert(header.frame, reference);
+      }
+
+      m_cache->close();
+    }
+
+  public:
+    // Must be called collectively
+    ReferenceBroadcaster(
+      std::shared_ptr<ReferenceCache> t_cache,
+      MPI_Comm const t_communicator,
+      int const t_head_node = 0,
+      unsigned const t_queue_length = 1024) :
+      m_messages(new util::Queue<Message>(t_queue_length)),
+      m_cache(t_cache),
+      m_comm(mpi::comm::duplicate(t_communicator)),
+      m_head_node(t_head_node) {
+
+      mpi::error::check(MPI_Barrier(m_comm));
+      m_broadcast_thread = std::thread(&ReferenceBroadcaster::broadcastThreadMain, this);
+    }
+
+    // Not copyable
+    ReferenceBroadcaster(ReferenceBroadcaster const &) = delete;
+    ReferenceBroadcaster& operator=(ReferenceBroadcaster const &) = delete;
+
+    // Head rank only, build and broadcast the reference of a frame
+    // Frame ids must increase from one call to the next.
+    void publish(unsigned const t_frame, Tile const& t_frame_tile) {
+      m_messages->enqueue(Message{Kind::Publish, t_frame, t_frame_tile});
+    }
+
+    // Head rank only, drop the reference of a frame on every rank
+    void forget(unsigned const t_frame) {
+      m_messages->enqueue(Message{Kind::Forget, t_frame, Tile()});
+    }
+
+    // Must be called collectively, pending publications go out first
+    // The head's thread drains the closed queue then broadcasts a stop,
+    // which is the only collective the other ranks' threads wait on, so
+    // there is no barrier here to race it on the same communicator.
+    ~ReferenceBroadcaster() {
+      m_messages->close();
+      m_broadcast_thread.join();
+
+      mpi::error::check(MPI_Comm_free(&m_comm));
+    }
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_REFERENCEBROADCASTER_INCLUDED
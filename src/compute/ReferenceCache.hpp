@@ -0,0 +1,79 @@
+#ifndef MPIBROT_COMPUTE_REFERENCECACHE_INCLUDED
+#define MPIBROT_COMPUTE_REFERENCECACHE_INCLUDED
+
+
+// Internal
+#include "compute/Tile.hpp"
+
+// Standard
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+
+
+namespace SimpleBrot {
+
+  // The frame references a rank holds, keyed by frame id
+  // References are published in frame id order, so once a later frame has
+  // been published a missing one was never published or has been forgotten.
+  // Tiles can reach a rank before the reference of their frame, lookups wait
+  // for it.
+  class ReferenceCache {
+  private:
+    std::mutex m_mutex;
+    std::condition_variable m_published;
+
+    std::map<unsigned, std::shared_ptr<FrameReference const>> m_references;
+    unsigned m_next_frame = 0;    // Frames below this have been published
+    bool m_closed = false;
+
+  public:
+    ReferenceCache() {}
+
+    // Not copyable
+    ReferenceCache(ReferenceCache const &) = delete;
+    ReferenceCache& operator=(ReferenceCache const &) = delete;
+
+    // Publish the reference of a frame, frames must be published in order
+    void insert(unsigned const t_frame, std::shared_ptr<FrameReference const> t_reference) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_references[t_frame] = t_reference;
+      m_next_frame = t_frame + 1;
+      m_published.notify_all();
+    }
+
+    // Drop the reference of a frame that will not be rendered any more
+    void erase(unsigned const t_frame) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_references.erase(t_frame);
+    }
+
+    // Wait for the reference of a frame, null if it was forgotten or the
+    // cache has been closed
+    std::shared_ptr<FrameReference const> lookup(unsigned const t_frame) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_published.wait(lock, [this, t_frame] {
+        return m_closed || t_frame < m_next_frame;
+      });
+
+      auto found = m_references.find(t_frame);
+      if(found == m_references.end()) {
+        return nullptr;
+      }
+
+      return found->second;
+    }
+
+    // Release waiting lookups, no more references will be published
+    void close() {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_closed = true;
+      m_published.notify_all();
+    }
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_REFERENCECACHE_INCLUDED
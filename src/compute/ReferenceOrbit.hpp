@@ -0,0 +1,167 @@
+#ifndef MPIBROT_COMPUTE_REFERENCEORBIT_INCLUDED
+#define MPIBROT_COMPUTE_REFERENCEORBIT_INCLUDED
+
+
+// Internal
+#include "compute/QuadDouble.hpp"
+#include "mpi/error.hpp"
+
+// External
+#include "boost/multiprecision/cpp_bin_float.hpp"
+#include "mpi.h"
+
+// Standard
+#include <vector>
+#include <string>
+#include <complex>
+#include <cmath>
+
+
+namespace SimpleBrot {
+
+  // Binary floating point with a fixed number of mantissa bits
+  // Expression templates are off, they only slow down short expressions
+  template<unsigned Bits>
+  using HighPrecision = boost::multiprecision::number<
+    boost::multiprecision::cpp_bin_float<Bits, boost::multiprecision::digit_base_2>,
+    boost::multiprecision::et_off>;
+
+
+  // A single orbit computed at high precision and rounded to doubles
+  // Pixels near the reference iterate their difference from it in
+  // hardware doubles, see compute/Perturbation.hpp
+  class ReferenceOrbit {
+  private:
+
+    // Z_0 = 0, Z_1 = c ... up to and including the escaping point
+    std::vector<std::complex<double>> orbit;
+
+    // Widen a coordinate to a working precision
+    template<unsigned Bits>
+    static HighPrecision<Bits> Widen(std::string const& x) {
+      return HighPrecision<Bits>(x);
+    }
+
+    template<unsigned Bits>
+    static HighPrecision<Bits> Widen(QuadDouble const& x) {
+      return HighPrecision<Bits>(x.x[0]) + HighPrecision<Bits>(x.x[1]) +
+        HighPrecision<Bits>(x.x[2]) + HighPrecision<Bits>(x.x[3]);
+    }
+
+    // Pick the working precision from the pixel spacing and iterate
+    template<class C>
+    void ComputeAtSpacing(
+      C const& cr,
+      C const& ci,
+      double const pixelSpacing,
+      unsigned const maxIterations,
+      unsigned const bailout) {
+
+      unsigned const bits = RequiredBits(pixelSpacing);
+
+      if(bits <= 128) {
+        this->Compute(Widen<128>(cr), Widen<128>(ci), maxIterations, bailout);
+      } else if(bits <= 256) {
+        this->Compute(Widen<256>(cr), Widen<256>(ci), maxIterations, bailout);
+      } else if(bits <= 512) {
+        this->Compute(Widen<512>(cr), Widen<512>(ci), maxIterations, bailout);
+      } else if(bits <= 1024) {
+        this->Compute(Widen<1024>(cr), Widen<1024>(ci), maxIterations, bailout);
+      } else {
+        this->Compute(Widen<2048>(cr), Widen<2048>(ci), maxIterations, bailout);
+      }
+    }
+
+  public:
+
+    ReferenceOrbit() {}
+
+    // Iterate the reference point at the precision of HP
+    template<class HP>
+    void Compute(
+      HP const& cr,
+      HP const& ci,
+      unsigned const maxIterations,
+      unsigned const bailout) {
+
+      HP const bailoutSquared = HP(bailout) * HP(bailout);
+      HP zr = 0;
+      HP zi = 0;
+
+      this->orbit.clear();
+      this->orbit.push_back(std::complex<double>(0, 0));
+
+      for(unsigned i = 0; i < maxIterations; i++) {
+        HP const zr2 = zr * zr;
+        HP const zi2 = zi * zi;
+
+        if(zr2 + zi2 >= bailoutSquared) {
+          break;
+        }
+
+        zi = 2 * zr * zi + ci;
+        zr = zr2 - zi2 + cr;
+
+        this->orbit.push_back(std::complex<double>(
+          zr.template convert_to<double>(),
+          zi.template convert_to<double>()));
+      }
+    }
+
+    // Mantissa bits needed to resolve pixels spaced this far apart
+    // 64 guard bits cover the digits lost over long orbits. A spacing too
+    // small to represent, or not a spacing at all, asks for the most bits
+    // rather than converting an infinite log to unsigned.
+    static unsigned RequiredBits(double const pixelSpacing) {
+      unsigned const most = 2048;
+
+      if(!(pixelSpacing > 0) || !std::isfinite(pixelSpacing)) {
+        return most;
+      }
+
+      double const bits = std::max(0.0, -std::log2(pixelSpacing)) + 64;
+      return bits < double(most) ? unsigned(bits) : most;
+    }
+
+    // Iterate a reference point given as decimal strings, the working
+    // precision is chosen from the pixel spacing of the render
+    void Compute(
+      std::string const& cr,
+      std::string const& ci,
+      double const pixelSpacing,
+      unsigned const maxIterations,
+      unsigned const bailout) {
+      this->ComputeAtSpacing(cr, ci, pixelSpacing, maxIterations, bailout);
+    }
+
+    // Iterate a reference point given in quad-double
+    void Compute(
+      QuadDouble const& cr,
+      QuadDouble const& ci,
+      double const pixelSpacing,
+      unsigned const maxIterations,
+      unsigned const bailout) {
+      this->ComputeAtSpacing(cr, ci, pixelSpacing, maxIterations, bailout);
+    }
+
+    // Number of stored orbit points, including Z_0
+    unsigned Length() const {return this->orbit.size();}
+
+    std::complex<double> const& Get(unsigned const n) const {
+      return this->orbit[n];
+    }
+
+    // Collective, copies the orbit on the root rank to all other ranks
+    void mpiBroadcast(int const t_root, MPI_Comm const t_comm) {
+      unsigned long length = this->orbit.size();
+      mpi::error::check(MPI_Bcast(&length, 1, MPI_UNSIGNED_LONG, t_root, t_comm));
+
+      this->orbit.resize(length);
+      mpi::error::check(MPI_Bcast(this->orbit.data(), length * 2, MPI_DOUBLE, t_root, t_comm));
+    }
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_REFERENCEORBIT_INCLUDED
@@ -0,0 +1,144 @@
+#ifndef MPIBROT_COMPUTE_SERIESAPPROXIMATION_INCLUDED
+#define MPIBROT_COMPUTE_SERIESAPPROXIMATION_INCLUDED
+
+
+// Internal
+#include "compute/ReferenceOrbit.hpp"
+#include "mpi/error.hpp"
+
+// External
+#include "mpi.h"
+
+// Standard
+#include <vector>
+#include <complex>
+#include <cmath>
+
+
+namespace SimpleBrot {
+
+  // Polynomial approximation of a perturbation delta after n iterations
+  //   dz_n ~= a_1 dc + a_2 dc^2 + ... + a_k dc^k
+  // The coefficients only depend on the reference orbit, so a whole view can
+  // jump straight to iteration n. As a complex polynomial in dc this is the
+  // usual bivariate real series in (dc.real, dc.imag).
+  class SeriesApproximation {
+  private:
+
+    // Iterations that may be skipped, and the coefficients at that point
+    unsigned skip;
+    std::vector<std::complex<double>> coefficients;
+
+    // Evaluate a set of coefficients at dc with Horner's scheme
+    static std::complex<double> Evaluate(
+      std::vector<std::complex<double>> const& a,
+      std::complex<double> const dc) {
+
+      std::complex<double> sum = 0;
+      for(unsigned k = a.size(); k > 0; k--) {
+        sum = (sum + a[k - 1]) * dc;
+      }
+      return sum;
+    }
+
+  public:
+
+    // A series that skips nothing, to be filled by mpiBroadcast
+    SeriesApproximation() : skip(0) {}
+
+    // Build the series for a view by advancing the coefficients alongside the
+    // exact deltas of a few probe points. The skip count is the last iteration
+    // at which the series still matched every probe to within the relative
+    // tolerance, and at which no probe needed to escape or rebase. Like any
+    // series skip this assumes pixels between the probes live as long as them.
+    SeriesApproximation(
+      ReferenceOrbit const& orbit,
+      std::vector<std::complex<double>> const& probes,
+      unsigned const bailout,
+      unsigned const terms = 4,
+      double const tolerance = 1e-12) :
+      skip(0), coefficients(terms, std::complex<double>(0, 0)) {
+
+      std::vector<std::complex<double>> a(terms, std::complex<double>(0, 0));
+      std::vector<std::complex<double>> next(terms);
+      std::vector<std::complex<double>> exact(probes.size(), std::complex<double>(0, 0));
+      double const bailoutSquared = double(bailout) * double(bailout);
+
+      // Stop one short of the end so the perturbation loop has a Z to use
+      for(unsigned n = 0; n + 2 < orbit.Length(); n++) {
+        std::complex<double> const twoZ = 2.0 * orbit.Get(n);
+
+        // a_k' = 2 Z a_k + sum(a_i a_j, i + j = k) + (k == 1)
+        for(unsigned k = 0; k < terms; k++) {
+          next[k] = twoZ * a[k];
+          for(unsigned i = 0; i < k; i++) {
+            unsigned j = k - 1 - i;
+            next[k] += a[i] * a[j];
+          }
+        }
+        next[0] += 1.0;
+
+        // Advance the probes exactly and check the series against them
+        bool valid = true;
+        for(unsigned p = 0; p < probes.size(); p++) {
+          exact[p] = (twoZ + exact[p]) * exact[p] + probes[p];
+
+          std::complex<double> const z = orbit.Get(n + 1) + exact[p];
+          std::complex<double> const error = Evaluate(next, probes[p]) - exact[p];
+
+          if(std::norm(z) < std::norm(exact[p]) || std::norm(z) >= bailoutSquared ||
+             std::abs(error) > tolerance * std::abs(exact[p])) {
+            valid = false;
+            break;
+          }
+        }
+
+        if(!valid) {
+          break;
+        }
+
+        a.swap(next);
+        this->skip = n + 1;
+        this->coefficients = a;
+      }
+    }
+
+    // Corners, edge midpoints and center of a view, relative to the reference
+    static std::vector<std::complex<double>> ProbeView(
+      std::complex<double> const deltaStart,
+      std::complex<double> const deltaEnd) {
+
+      std::vector<std::complex<double>> probes;
+      for(unsigned i = 0; i < 3; i++) {
+        for(unsigned j = 0; j < 3; j++) {
+          probes.push_back(std::complex<double>(
+            deltaStart.real() + (deltaEnd.real() - deltaStart.real()) * j / 2,
+            deltaStart.imag() + (deltaEnd.imag() - deltaStart.imag()) * i / 2));
+        }
+      }
+      return probes;
+    }
+
+    // Number of iterations every pixel of the view can skip
+    unsigned Skip() const {return this->skip;}
+
+    // Approximate delta after Skip() iterations
+    std::complex<double> Delta(std::complex<double> const dc) const {
+      return Evaluate(this->coefficients, dc);
+    }
+
+    // Collective, copies the series on the root rank to all other ranks
+    void mpiBroadcast(int const t_root, MPI_Comm const t_comm) {
+      unsigned long header[2] = {this->skip, this->coefficients.size()};
+      mpi::error::check(MPI_Bcast(header, 2, MPI_UNSIGNED_LONG, t_root, t_comm));
+
+      this->skip = header[0];
+      this->coefficients.resize(header[1]);
+      mpi::error::check(MPI_Bcast(this->coefficients.data(), header[1] * 2, MPI_DOUBLE, t_root, t_comm));
+    }
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_SERIESAPPROXIMATION_INCLUDED
@@ -0,0 +1,158 @@
+#ifndef MPIBROT_COMPUTE_SIMDKERNEL_INCLUDED
+#define MPIBROT_COMPUTE_SIMDKERNEL_INCLUDED
+
+
+// Internal
+#include "compute/DoubleDouble.hpp"
+#include "compute/Engine.hpp"
+#include "compute/KernelStats.hpp"
+
+
+namespace SimpleBrot {
+  namespace Simd {
+
+    // Vectorised row kernels, each defined in its own translation unit
+    // under compute/kernels/ so it can be built with matching ISA flags.
+    // The caller is responsible for only calling kernels the CPU supports.
+    // smooth and distance may be null, otherwise they receive continuous
+    // iteration counts and exterior distance estimates. row[0] is column
+    // firstColumn of the grid, c.real() = re0 + rStep * (firstColumn + j).
+    void FillIterationRowSse2(
+      unsigned* row, unsigned const width,
+      float const re0, float const rStep, float const im,
+      unsigned const maxIterations, unsigned const bailout,
+      float const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn);
+
+    void FillIterationRowSse2(
+      unsigned* row, unsigned const width,
+      double const re0, double const rStep, double const im,
+      unsigned const maxIterations, unsigned const bailout,
+      double const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn);
+
+    void FillIterationRowSse2(
+      unsigned* row, unsigned const width,
+      DoubleDouble const re0, DoubleDouble const rStep, DoubleDouble const im,
+      unsigned const maxIterations, unsigned const bailout,
+      DoubleDouble const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn);
+
+    void FillIterationRowAvx2(
+      unsigned* row, unsigned const width,
+      float const re0, float const rStep, float const im,
+      unsigned const maxIterations, unsigned const bailout,
+      float const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn);
+
+    void FillIterationRowAvx2(
+      unsigned* row, unsigned const width,
+      double const re0, double const rStep, double const im,
+      unsigned const maxIterations, unsigned const bailout,
+      double const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn);
+
+    void FillIterationRowAvx2(
+      unsigned* row, unsigned const width,
+      DoubleDouble const re0, DoubleDouble const rStep, DoubleDouble const im,
+      unsigned const maxIterations, unsigned const bailout,
+      DoubleDouble const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn);
+
+    void FillIterationRowAvx512(
+      unsigned* row, unsigned const width,
+      float const re0, float const rStep, float const im,
+      unsigned const maxIterations, unsigned const bailout,
+      float const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn);
+
+    void FillIterationRowAvx512(
+      unsigned* row, unsigned const width,
+      double const re0, double const rStep, double const im,
+      unsigned const maxIterations, unsigned const bailout,
+      double const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn);
+
+    void FillIterationRowAvx512(
+      unsigned* row, unsigned const width,
+      DoubleDouble const re0, DoubleDouble const rStep, DoubleDouble const im,
+      unsigned const maxIterations, unsigned const bailout,
+      DoubleDouble const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn);
+
+
+    // Route a row to the kernel for an engine
+    // T must be float, double or DoubleDouble
+    template<class T>
+    bool DispatchIterationRow(
+      Engine const engine,
+      unsigned* row, unsigned const width,
+      T const re0, T const rStep, T const im,
+      unsigned const maxIterations, unsigned const bailout,
+      T const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn) {
+
+      switch(engine) {
+        case Engine::Sse2:
+          FillIterationRowSse2(row, width, re0, rStep, im, maxIterations, bailout, periodicityTolerance, stats, smooth, distance, firstColumn);
+          return true;
+        case Engine::Avx2:
+          FillIterationRowAvx2(row, width, re0, rStep, im, maxIterations, bailout, periodicityTolerance, stats, smooth, distance, firstColumn);
+          return true;
+        case Engine::Avx512:
+          FillIterationRowAvx512(row, width, re0, rStep, im, maxIterations, bailout, periodicityTolerance, stats, smooth, distance, firstColumn);
+          return true;
+        default:
+          return false;
+      }
+    }
+
+
+    // Fill a row using the requested engine
+    // Returns false if the engine has no kernel for this precision type
+    template<class T>
+    bool FillIterationRow(
+      Engine const engine,
+      unsigned* row, unsigned const width,
+      T const re0, T const rStep, T const im,
+      unsigned const maxIterations, unsigned const bailout,
+      T const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn = 0) {
+      return false;
+    }
+
+    inline bool FillIterationRow(
+      Engine const engine,
+      unsigned* row, unsigned const width,
+      float const re0, float const rStep, float const im,
+      unsigned const maxIterations, unsigned const bailout,
+      float const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn = 0) {
+      return DispatchIterationRow(engine, row, width, re0, rStep, im, maxIterations, bailout, periodicityTolerance, stats, smooth, distance, firstColumn);
+    }
+
+    inline bool FillIterationRow(
+      Engine const engine,
+      unsigned* row, unsigned const width,
+      double const re0, double const rStep, double const im,
+      unsigned const maxIterations, unsigned const bailout,
+      double const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn = 0) {
+      return DispatchIterationRow(engine, row, width, re0, rStep, im, maxIterations, bailout, periodicityTolerance, stats, smooth, distance, firstColumn);
+    }
+
+    inline bool FillIterationRow(
+      Engine const engine,
+      unsigned* row, unsigned const width,
+      DoubleDouble const re0, DoubleDouble const rStep, DoubleDouble const im,
+      unsigned const maxIterations, unsigned const bailout,
+      DoubleDouble const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn = 0) {
+      return DispatchIterationRow(engine, row, width, re0, rStep, im, maxIterations, bailout, periodicityTolerance, stats, smooth, distance, firstColumn);
+    }
+
+  } // namespace Simd
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_SIMDKERNEL_INCLUDED
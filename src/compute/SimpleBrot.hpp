@@ -3,33 +3,227 @@
 
 
 // Internal
+#include "compute/Engine.hpp"
+#include "compute/Escape.hpp"
+#include "compute/KernelStats.hpp"
+#include "compute/SimdKernel.hpp"
 #include "util/Buffer2D.hpp"
 
 // Standard
+#include <algorithm>
+#include <cmath>
 #include <complex>
+#include <vector>
 
 
 namespace SimpleBrot {
 
+  // Whether c lies in the main cardioid or the period 2 bulb
+  // Both are analytic, so points inside need not be iterated at all
+  template<class T>
+  bool InMainCardioidOrBulb(std::complex<T> const& c) {
+    T const y2 = c.imag() * c.imag();
+    T const xq = c.real() - T(0.25);
+    T const q = xq * xq + y2;
+    T const xb = c.real() + T(1);
+
+    return (q * (q + xq) <= T(0.25) * y2) || (xb * xb + y2 <= T(0.0625));
+  }
+
+
+  // Periodicity checking tolerance for a given pixel spacing
+  // Orbits that return this close to an earlier point are treated as
+  // attracted to a cycle, a small fraction of a pixel keeps false
+  // positives from slowly escaping boundary points below visible size
+  template<class T>
+  T PeriodicityTolerance(T const rStep, T const iStep) {
+    T const r = rStep < T(0) ? -rStep : rStep;
+    T const i = iStep < T(0) ? -iStep : iStep;
+    return (r < i ? r : i) / T(1024);
+  }
+
+
+  // Square a value, overload for types with a cheaper squaring routine
+  template<class T>
+  inline T Square(T const& x) {
+    return x * x;
+  }
+
+
   // Compute a single pixel orbit
+  // The orbit is kept as separate real and imaginary parts so each step is
+  // three multiplies, and the squared terms double as the squared magnitude
+  // tested against bailout squared, avoiding a sqrt per iteration. This is
+  // the same arithmetic, in the same order, as the lane kernels in simd/.
+  // With a positive periodicityTolerance the orbit is compared against a
+  // point saved at every power of two iteration (Brent's method), catching
+  // cycles of any period and returning maxIterations for them early.
+  // If escape is given the final orbit point is recorded in it, along with
+  // the derivative dz/dc when escape->trackDerivative is set.
   template<class T>
   unsigned ComputeIterationCount(
     std::complex<T> const& c,
     unsigned const maxIterations,
-    unsigned const bailout) {
+    unsigned const bailout,
+    T const periodicityTolerance = T(0),
+    KernelStats* stats = nullptr,
+    EscapeState<T>* escape = nullptr) {
+
+    // Interior points only provably never escape for bailout >= 2
+    if(bailout >= 2 && InMainCardioidOrBulb(c)) {
+      if(stats != nullptr) {
+        stats->interiorShortCircuits++;
+      }
+      return maxIterations;
+    }
 
-    std::complex<T> z;
+    T const cr = c.real();
+    T const ci = c.imag();
+    T const bailoutSquared = T(bailout) * T(bailout);
+
+    T zr = T(0);
+    T zi = T(0);
+    T zr2 = T(0);
+    T zi2 = T(0);
     unsigned iterationCount = 0;
 
-    while(abs(z) < bailout && iterationCount < maxIterations) {
-      z = pow(z, 2) + c;
+    // Skipped if the tolerance squared is too small to represent
+    T const toleranceSquared = periodicityTolerance * periodicityTolerance;
+    bool const checkPeriodicity = toleranceSquared > T(0);
+    T savedr = T(0);
+    T savedi = T(0);
+    unsigned checkpoint = 1;
+
+    // dz/dc, stepped as dz = 2 z dz + 1 before z itself
+    bool const trackDerivative = escape != nullptr && escape->trackDerivative;
+    T dzr = T(0);
+    T dzi = T(0);
+
+    while(zr2 + zi2 < bailoutSquared && iterationCount < maxIterations) {
+      if(trackDerivative) {
+        T const tr = zr * dzr - zi * dzi;
+        T const ti = zr * dzi + zi * dzr;
+        dzr = tr + tr + T(1);
+        dzi = ti + ti;
+      }
+
+      zi = (zr + zr) * zi + ci;
+      zr = zr2 - zi2 + cr;
+      zr2 = Square(zr);
+      zi2 = Square(zi);
       iterationCount++;
+
+      if(checkPeriodicity) {
+        T const dr = zr - savedr;
+        T const di = zi - savedi;
+
+        if(Square(dr) + Square(di) <= toleranceSquared) {
+          if(stats != nullptr) {
+            stats->periodicExits++;
+          }
+          return maxIterations;
+        }
+
+        if(iterationCount == checkpoint) {
+          savedr = zr;
+          savedi = zi;
+          checkpoint *= 2;
+        }
+      }
+    }
+
+    if(escape != nullptr) {
+      escape->magnitudeSquared = zr2 + zi2;
+      escape->zr = zr;
+      escape->zi = zi;
+      escape->dzr = dzr;
+      escape->dzi = dzi;
     }
 
     return iterationCount;
   }
 
 
+  // Continuous iteration count for a single pixel
+  template<class T>
+  float ComputeSmoothIterationCount(
+    std::complex<T> const& c,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    T const periodicityTolerance = T(0),
+    KernelStats* stats = nullptr) {
+
+    EscapeState<T> escape;
+    unsigned const iterations = ComputeIterationCount(
+      c, maxIterations, bailout, periodicityTolerance, stats, &escape);
+
+    return SmoothIterationCount(iterations, ToDouble(escape.magnitudeSquared), maxIterations, bailout);
+  }
+
+
+  // Exterior distance estimate for a single pixel, 0 for interior points
+  template<class T>
+  float ComputeDistanceEstimate(
+    std::complex<T> const& c,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    T const periodicityTolerance = T(0),
+    KernelStats* stats = nullptr) {
+
+    EscapeState<T> escape;
+    escape.trackDerivative = true;
+    unsigned const iterations = ComputeIterationCount(
+      c, maxIterations, bailout, periodicityTolerance, stats, &escape);
+
+    return DistanceEstimate(iterations, maxIterations, escape, c.real(), c.imag());
+  }
+
+
+  // Fill a single row of iteration counts, one orbit at a time
+  // smooth and distance optionally receive the continuous counts and the
+  // exterior distance estimates alongside. row[0] is column firstColumn of
+  // the grid, so parts of a row come out exactly as the whole row would.
+  template<class T>
+  void FillIterationRow(
+    unsigned* row,
+    unsigned const width,
+    T const re0,
+    T const rStep,
+    T const im,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    T const periodicityTolerance = T(0),
+    KernelStats* stats = nullptr,
+    float* smooth = nullptr,
+    float* distance = nullptr,
+    unsigned const firstColumn = 0) {
+
+    for(unsigned j = 0; j < width; j++) {
+      std::complex<T> c = std::complex<T>(re0 + (rStep * (firstColumn + j)), im);
+
+      if(smooth == nullptr && distance == nullptr) {
+        row[j] = ComputeIterationCount(c, maxIterations, bailout, periodicityTolerance, stats);
+        continue;
+      }
+
+      EscapeState<T> escape;
+      escape.trackDerivative = (distance != nullptr);
+      row[j] = ComputeIterationCount(c, maxIterations, bailout, periodicityTolerance, stats, &escape);
+
+      if(smooth != nullptr) {
+        smooth[j] = SmoothIterationCount(row[j], ToDouble(escape.magnitudeSquared), maxIterations, bailout);
+      }
+      if(distance != nullptr) {
+        distance[j] = DistanceEstimate(row[j], maxIterations, escape, c.real(), c.imag());
+      }
+    }
+
+    if(stats != nullptr) {
+      stats->iteratedPixels += width;
+    }
+  }
+
+
   // Generate a 2d buffer full of iteration counts
   template<class T>
   void FillIterationBuffer(
@@ -37,27 +231,245 @@ namespace SimpleBrot {
     std::complex<T> const start,
     std::complex<T> const end,
     unsigned const maxIterations,
-    unsigned const bailout) {
+    unsigned const bailout,
+    KernelStats* stats = nullptr) {
 
     // Compute step sizes for pixels
-    float rStep = (end.real() - start.real()) / data.Width();
-    float iStep = (end.imag() - start.imag()) / data.Height();
+    T rStep = (end.real() - start.real()) / data.Width();
+    T iStep = (end.imag() - start.imag()) / data.Height();
+    T tolerance = PeriodicityTolerance(rStep, iStep);
 
-    // Iterate over pixels in buffer
+    // Iterate over rows in buffer
     for(unsigned i = 0; i < data.Height(); i++) {
-      for(unsigned j = 0; j < data.Width(); j++) {
+      FillIterationRow(
+        &data.Get(0, i), data.Width(),
+        start.real(), rStep, start.imag() + (iStep * i),
+        maxIterations, bailout, tolerance, stats);
+    }
+  }
+
+
+  // Generate a 2d buffer full of iteration counts using a specific engine
+  // Precision types without a vectorised kernel fall back to the scalar path
+  template<class T>
+  void FillIterationBuffer(
+    Buffer2D<unsigned>& data,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    Engine const engine,
+    KernelStats* stats = nullptr) {
+
+    T rStep = (end.real() - start.real()) / data.Width();
+    T iStep = (end.imag() - start.imag()) / data.Height();
+    T tolerance = PeriodicityTolerance(rStep, iStep);
+
+    for(unsigned i = 0; i < data.Height(); i++) {
+      unsigned* row = &data.Get(0, i);
+      T const im = start.imag() + (iStep * i);
+
+      bool const vectorised = (engine != Engine::Scalar) && Simd::FillIterationRow(
+        engine, row, data.Width(), start.real(), rStep, im,
+        maxIterations, bailout, tolerance, stats, nullptr, nullptr);
+
+      if(!vectorised) {
+        FillIterationRow(
+          row, data.Width(), start.real(), rStep, im,
+          maxIterations, bailout, tolerance, stats);
+      }
+    }
+  }
+
+
+  // Generate a 2d buffer of continuous iteration counts
+  // Same orbits as FillIterationBuffer, the fractional part comes from the
+  // final |z| inside the kernel rather than a second pass over the orbits
+  template<class T>
+  void FillSmoothIterationBuffer(
+    Buffer2D<float>& data,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    KernelStats* stats = nullptr) {
+
+    T rStep = (end.real() - start.real()) / data.Width();
+    T iStep = (end.imag() - start.imag()) / data.Height();
+    T tolerance = PeriodicityTolerance(rStep, iStep);
+
+    std::vector<unsigned> counts(data.Width());
+    for(unsigned i = 0; i < data.Height(); i++) {
+      FillIterationRow(
+        counts.data(), data.Width(),
+        start.real(), rStep, start.imag() + (iStep * i),
+        maxIterations, bailout, tolerance, stats, &data.Get(0, i));
+    }
+  }
+
+
+  // Generate continuous iteration counts for part of a larger pixel grid
+  // Pixel (j, i) of data is grid point (originX + j, originY + i), at
+  // start + (rStep, iStep) times its position. Parts of a grid come out
+  // exactly as a render of the whole grid would.
+  template<class T>
+  void FillSmoothIterationGrid(
+    Buffer2D<float>& data,
+    std::complex<T> const start,
+    T const rStep,
+    T const iStep,
+    unsigned const originX,
+    unsigned const originY,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    Engine const engine,
+    KernelStats* stats = nullptr) {
+
+    T tolerance = PeriodicityTolerance(rStep, iStep);
+
+    std::vector<unsigned> counts(data.Width());
+    for(unsigned i = 0; i < data.Height(); i++) {
+      float* smooth = &data.Get(0, i);
+      T const im = start.imag() + (iStep * (originY + i));
+
+      bool const vectorised = (engine != Engine::Scalar) && Simd::FillIterationRow(
+        engine, counts.data(), data.Width(), start.real(), rStep, im,
+        maxIterations, bailout, tolerance, stats, smooth, nullptr, originX);
+
+      if(!vectorised) {
+        FillIterationRow(
+          counts.data(), data.Width(), start.real(), rStep, im,
+          maxIterations, bailout, tolerance, stats, smooth, nullptr, originX);
+      }
+    }
+  }
+
+
+  // Generate a 2d buffer of continuous iteration counts using a specific engine
+  template<class T>
+  void FillSmoothIterationBuffer(
+    Buffer2D<float>& data,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    Engine const engine,
+    KernelStats* stats = nullptr) {
+
+    T rStep = (end.real() - start.real()) / data.Width();
+    T iStep = (end.imag() - start.imag()) / data.Height();
+
+    FillSmoothIterationGrid(data, start, rStep, iStep, 0, 0, maxIterations, bailout, engine, stats);
+  }
+
+
+  // Generate iteration counts and exterior distance estimates together
+  // dz/dc is iterated alongside z, distances are in the units of c
+  template<class T>
+  void FillDistanceEstimateBuffer(
+    Buffer2D<unsigned>& data,
+    Buffer2D<float>& distance,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    KernelStats* stats = nullptr) {
+
+    T rStep = (end.real() - start.real()) / data.Width();
+    T iStep = (end.imag() - start.imag()) / data.Height();
+    T tolerance = PeriodicityTolerance(rStep, iStep);
+
+    for(unsigned i = 0; i < data.Height(); i++) {
+      FillIterationRow(
+        &data.Get(0, i), data.Width(),
+        start.real(), rStep, start.imag() + (iStep * i),
+        maxIterations, bailout, tolerance, stats, nullptr, &distance.Get(0, i));
+    }
+  }
+
+
+  // Generate iteration counts and distance estimates using a specific engine
+  template<class T>
+  void FillDistanceEstimateBuffer(
+    Buffer2D<unsigned>& data,
+    Buffer2D<float>& distance,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    Engine const engine,
+    KernelStats* stats = nullptr) {
+
+    T rStep = (end.real() - start.real()) / data.Width();
+    T iStep = (end.imag() - start.imag()) / data.Height();
+    T tolerance = PeriodicityTolerance(rStep, iStep);
+
+    for(unsigned i = 0; i < data.Height(); i++) {
+      unsigned* row = &data.Get(0, i);
+      float* distances = &distance.Get(0, i);
+      T const im = start.imag() + (iStep * i);
+
+      bool const vectorised = (engine != Engine::Scalar) && Simd::FillIterationRow(
+        engine, row, data.Width(), start.real(), rStep, im,
+        maxIterations, bailout, tolerance, stats, nullptr, distances);
+
+      if(!vectorised) {
+        FillIterationRow(
+          row, data.Width(), start.real(), rStep, im,
+          maxIterations, bailout, tolerance, stats, nullptr, distances);
+      }
+    }
+  }
+
+
+  // Supersampled continuous iteration count
+  // Averaging in float keeps the fractional parts that unsigned would drop.
+  // Supersample rows are streamed, one is iterated at a time and folded
+  // into a row of running sums, so memory is a few rows however tall the
+  // output is. Rows and sums are in the same order as a full size buffer.
+  template<class T>
+  void ComputeSmoothIterations(
+    Buffer2D<float>& data,
+    std::complex<T> const start,
+    std::complex<T> const end,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    unsigned const scale) {
+
+    unsigned const superWidth = data.Width() * scale;
+    T rStep = (end.real() - start.real()) / superWidth;
+    T iStep = (end.imag() - start.imag()) / (data.Height() * scale);
+    T tolerance = PeriodicityTolerance(rStep, iStep);
 
-        std::complex<T> c = std::complex<T>(
-          start.real() + (rStep * j),
-          start.imag() + (iStep * i));
+    std::vector<unsigned> counts(superWidth);
+    std::vector<float> superSampleRow(superWidth);
+    std::vector<float> sums(data.Width());
+
+    for(unsigned i = 0; i < data.Height(); i++) {
+      std::fill(sums.begin(), sums.end(), 0.0f);
+
+      for(unsigned k = 0; k < scale; k++) {
+        FillIterationRow(
+          counts.data(), superWidth,
+          start.real(), rStep, start.imag() + (iStep * (i * scale + k)),
+          maxIterations, bailout, tolerance, nullptr, superSampleRow.data());
+
+        for(unsigned j = 0; j < data.Width(); j++) {
+          for(unsigned l = 0; l < scale; l++) {
+            sums[j] += superSampleRow[j * scale + l];
+          }
+        }
+      }
 
-        data.Get(j, i) = ComputeIterationCount(c, maxIterations, bailout);
+      for(unsigned j = 0; j < data.Width(); j++) {
+        data.Get(j, i) = sums[j] / (scale * scale);
       }
     }
   }
 
 
   // Supersampled iteration count
+  // Streams supersample rows the same way as ComputeSmoothIterations
   template<class T>
   void ComputeIterations(
     Buffer2D<unsigned>& data,
@@ -67,21 +479,33 @@ namespace SimpleBrot {
     unsigned const bailout,
     unsigned const scale) {
 
-    // Generate a scaled buffer and compute iterations into it
-    Buffer2D<unsigned> superSampleBuffer(data.Width() * scale, data.Height() * scale);
-    FillIterationBuffer(
-      superSampleBuffer, start, end, maxIterations, bailout);
+    unsigned const superWidth = data.Width() * scale;
+    T rStep = (end.real() - start.real()) / superWidth;
+    T iStep = (end.imag() - start.imag()) / (data.Height() * scale);
+    T tolerance = PeriodicityTolerance(rStep, iStep);
+
+    std::vector<unsigned> superSampleRow(superWidth);
+    std::vector<float> sums(data.Width());
 
-    // Iterate over output buffer computing sample averages
     for(unsigned i = 0; i < data.Height(); i++) {
-      for(unsigned j = 0; j < data.Width(); j++) {
-        float sum = 0;
-        for(unsigned k = 0; k < scale; k++) {
+      std::fill(sums.begin(), sums.end(), 0.0f);
+
+      for(unsigned k = 0; k < scale; k++) {
+        FillIterationRow(
+          superSampleRow.data(), superWidth,
+          start.real(), rStep, start.imag() + (iStep * (i * scale + k)),
+          maxIterations, bailout, tolerance);
+
+        for(unsigned j = 0; j < data.Width(); j++) {
           for(unsigned l = 0; l < scale; l++) {
-            sum += superSampleBuffer.Get(j * scale + l, i * scale + k);
+            sums[j] += superSampleRow[j * scale + l];
           }
         }
-        data.Get(j, i) = sum / pow(scale, 2);
+      }
+
+      // Compute sample averages
+      for(unsigned j = 0; j < data.Width(); j++) {
+        data.Get(j, i) = sums[j] / pow(scale, 2);
       }
     }
   }
@@ -0,0 +1,316 @@
+#ifndef MPIBROT_COMPUTE_TILE_INCLUDED
+#define MPIBROT_COMPUTE_TILE_INCLUDED
+
+
+// Internal
+#include "compute/AdaptiveSupersample.hpp"
+#include "compute/Engine.hpp"
+#include "compute/KernelStats.hpp"
+#include "compute/Perturbation.hpp"
+#include "compute/Precision.hpp"
+#include "compute/QuadDouble.hpp"
+#include "compute/ReferenceOrbit.hpp"
+#include "compute/SeriesApproximation.hpp"
+#include "compute/SimpleBrot.hpp"
+#include "mpi/error.hpp"
+#include "util/Buffer2D.hpp"
+
+// External
+#include "mpi.h"
+
+// Standard
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+
+namespace SimpleBrot {
+
+  // A rectangle of pixels from a frame, the unit of work for rendering
+  // The viewport is that of the whole frame, so every tile of a frame maps
+  // its pixels onto the same grid and tiles stitch together without seams.
+  // A tile covering its entire frame describes the frame itself.
+  struct Tile {
+    std::complex<QuadDouble> start;   // Frame viewport corners
+    std::complex<QuadDouble> end;
+    unsigned frameWidth = 0;          // Frame size in pixels
+    unsigned frameHeight = 0;
+
+    unsigned x = 0;                   // Pixel rectangle within the frame
+    unsigned y = 0;
+    unsigned width = 0;
+    unsigned height = 0;
+
+    Precision precision = Precision::Double;
+    unsigned maxIterations = 256;
+    unsigned bailout = 2;
+    unsigned supersampling = 1;       // Strata per side for edge pixels, 1 for none
+  };
+
+
+  // Describe a whole frame, choosing the precision from its pixel spacing
+  inline Tile FrameTile(
+    std::complex<QuadDouble> const& start,
+    std::complex<QuadDouble> const& end,
+    unsigned const width,
+    unsigned const height,
+    unsigned const maxIterations,
+    unsigned const bailout,
+    unsigned const supersampling = 1) {
+
+    Tile frame;
+    frame.start = start;
+    frame.end = end;
+    frame.frameWidth = width;
+    frame.frameHeight = height;
+    frame.width = width;
+    frame.height = height;
+    frame.maxIterations = maxIterations;
+    frame.bailout = bailout;
+    frame.supersampling = supersampling;
+
+    double const rSpacing = std::fabs((end.real() - start.real()).ToDouble()) / width;
+    double const iSpacing = std::fabs((end.imag() - start.imag()).ToDouble()) / height;
+    frame.precision = SelectPrecision(std::min(rSpacing, iSpacing));
+
+    return frame;
+  }
+
+
+  // Split a frame into tiles of at most tileWidth x tileHeight, in scan order
+  inline std::vector<Tile> SplitFrame(Tile const& frame, unsigned const tileWidth, unsigned const tileHeight) {
+    std::vector<Tile> tiles;
+
+    for(unsigned y = 0; y < frame.height; y += tileHeight) {
+      for(unsigned x = 0; x < frame.width; x += tileWidth) {
+        Tile tile = frame;
+        tile.x = frame.x + x;
+        tile.y = frame.y + y;
+        tile.width = std::min(tileWidth, frame.width - x);
+        tile.height = std::min(tileHeight, frame.height - y);
+        tiles.push_back(tile);
+      }
+    }
+
+    return tiles;
+  }
+
+
+  // A tile grown by one pixel on every side, clipped to its frame
+  inline Tile WithApron(Tile const& tile) {
+    Tile padded = tile;
+    padded.x = tile.x > 0 ? tile.x - 1 : 0;
+    padded.y = tile.y > 0 ? tile.y - 1 : 0;
+    padded.width = std::min(tile.x + tile.width + 1, tile.frameWidth) - padded.x;
+    padded.height = std::min(tile.y + tile.height + 1, tile.frameHeight) - padded.y;
+    return padded;
+  }
+
+
+  // Copy a tile out of a render of its apron, and find the tile's edges
+  // there so pixels on its border are compared against the same neighbours
+  // as in a whole frame render
+  inline std::vector<bool> CropApron(
+    Tile const& tile,
+    Tile const& padded,
+    Buffer2D<float>& apron,
+    Buffer2D<float>& data,
+    float const threshold) {
+
+    unsigned const ox = tile.x - padded.x;
+    unsigned const oy = tile.y - padded.y;
+    std::vector<bool> edge(tile.width * tile.height);
+
+    for(unsigned i = 0; i < tile.height; i++) {
+      for(unsigned j = 0; j < tile.width; j++) {
+        data.Get(j, i) = apron.Get(ox + j, oy + i);
+        edge[i * tile.width + j] = IsEdge(apron, ox + j, oy + i, threshold);
+      }
+    }
+
+    return edge;
+  }
+
+
+  // Render a tile at a given value type
+  // Pixels are placed on the grid of the whole frame rather than from the
+  // tile's own corners, so every tile is rendered exactly as the whole frame
+  // would be.
+  template<class T>
+  void RenderTileAt(
+    Tile const& tile,
+    Buffer2D<float>& data,
+    Engine const engine,
+    KernelStats* stats) {
+
+    std::complex<T> const start(NarrowTo<T>(tile.start.real()), NarrowTo<T>(tile.start.imag()));
+    std::complex<T> const end(NarrowTo<T>(tile.end.real()), NarrowTo<T>(tile.end.imag()));
+    T const rStep = (end.real() - start.real()) / tile.frameWidth;
+    T const iStep = (end.imag() - start.imag()) / tile.frameHeight;
+
+    if(tile.supersampling < 2) {
+      FillSmoothIterationGrid(
+        data, start, rStep, iStep, tile.x, tile.y, tile.maxIterations, tile.bailout, engine, stats);
+      return;
+    }
+
+    Tile const padded = WithApron(tile);
+    Buffer2D<float> apron(padded.width, padded.height);
+    FillSmoothIterationGrid(
+      apron, start, rStep, iStep, padded.x, padded.y, tile.maxIterations, tile.bailout, engine, stats);
+
+    std::vector<bool> const edge = CropApron(tile, padded, apron, data, 1.0f);
+    SupersampleGridEdges(
+      data, start, rStep, iStep, tile.x, tile.y, tile.maxIterations, tile.bailout,
+      tile.supersampling, edge, stats);
+  }
+
+
+  // Whether tiles at a precision render by perturbation
+  // Double-double still has vector kernels that give every engine the same
+  // counts, deeper precisions are scalar only and iterate far slower than
+  // double deltas from a reference orbit.
+  inline bool IsPerturbed(Precision const precision) {
+    return precision == Precision::QuadDouble ||
+      precision == Precision::FixedPoint;
+  }
+
+
+  // What every perturbed tile of a frame shares
+  // One high precision reference orbit through the frame centre, its series
+  // approximation and the frame's pixel grid relative to the centre. None of
+  // it depends on the tile, so it is built once per frame and every tile is
+  // rendered exactly as the whole frame would be.
+  struct FrameReference {
+    ReferenceOrbit orbit;
+    SeriesApproximation series;
+    std::complex<double> deltaStart;  // Frame start relative to the centre
+    std::complex<double> step;        // Pixel spacing
+
+    // Empty, to be filled by mpiBroadcast
+    FrameReference() {}
+
+    // Iterate the reference of the frame a tile belongs to
+    explicit FrameReference(Tile const& tile) {
+      QuadDouble const rSpan = tile.end.real() - tile.start.real();
+      QuadDouble const iSpan = tile.end.imag() - tile.start.imag();
+      QuadDouble const cr = tile.start.real() + rSpan * QuadDouble(0.5);
+      QuadDouble const ci = tile.start.imag() + iSpan * QuadDouble(0.5);
+
+      this->deltaStart = std::complex<double>(
+        (tile.start.real() - cr).ToDouble(), (tile.start.imag() - ci).ToDouble());
+      std::complex<double> const deltaEnd(
+        (tile.end.real() - cr).ToDouble(), (tile.end.imag() - ci).ToDouble());
+      this->step = std::complex<double>(
+        (rSpan / QuadDouble(tile.frameWidth)).ToDouble(),
+        (iSpan / QuadDouble(tile.frameHeight)).ToDouble());
+
+      this->orbit.Compute(
+        cr, ci, std::min(std::fabs(this->step.real()), std::fabs(this->step.imag())),
+        tile.maxIterations, tile.bailout);
+
+      this->series = SeriesApproximation(
+        this->orbit, SeriesApproximation::ProbeView(this->deltaStart, deltaEnd), tile.bailout);
+    }
+
+    // Collective, copies the reference on the root rank to all other ranks
+    void mpiBroadcast(int const t_root, MPI_Comm const t_comm) {
+      this->orbit.mpiBroadcast(t_root, t_comm);
+      this->series.mpiBroadcast(t_root, t_comm);
+
+      double grid[4] = {
+        this->deltaStart.real(), this->deltaStart.imag(), this->step.real(), this->step.imag()
+      };
+      mpi::error::check(MPI_Bcast(grid, 4, MPI_DOUBLE, t_root, t_comm));
+
+      this->deltaStart = std::complex<double>(grid[0], grid[1]);
+      this->step = std::complex<double>(grid[2], grid[3]);
+    }
+  };
+
+
+  // Render a tile by perturbation around the reference of its frame
+  // Past double precision one high precision reference orbit plus double
+  // deltas is far cheaper than iterating every pixel in software floating
+  // point, and a series approximation skips the start of every orbit.
+  inline void RenderTilePerturbed(
+    Tile const& tile,
+    Buffer2D<float>& data,
+    FrameReference const& reference,
+    KernelStats* stats) {
+
+    ReferenceOrbit const& orbit = reference.orbit;
+    SeriesApproximation const* series = &reference.series;
+
+    if(tile.supersampling < 2) {
+      FillSmoothIterationBufferPerturbed(
+        data, orbit, reference.deltaStart, reference.step, tile.maxIterations, tile.bailout,
+        series, stats, tile.x, tile.y);
+      return;
+    }
+
+    Tile const padded = WithApron(tile);
+    Buffer2D<float> apron(padded.width, padded.height);
+    FillSmoothIterationBufferPerturbed(
+      apron, orbit, reference.deltaStart, reference.step, tile.maxIterations, tile.bailout,
+      series, stats, padded.x, padded.y);
+
+    std::vector<bool> const edge = CropApron(tile, padded, apron, data, 1.0f);
+    SupersampleEdgesPerturbed(
+      data, orbit, reference.deltaStart, reference.step, tile.maxIterations, tile.bailout,
+      tile.supersampling, edge, series, stats, tile.x, tile.y);
+  }
+
+
+  // Render a tile of continuous iteration counts into data
+  // data is resized to the tile, pixel (0, 0) is frame pixel (x, y)
+  // Precisions past double-double go through perturbation, engine only
+  // applies to the directly iterated ones. With supersampling, edges are
+  // found on the tile plus a one pixel apron, so tiled and whole frame
+  // renders take the same subsamples. Perturbed tiles use reference, the
+  // FrameReference of their frame, and only build their own when it is not
+  // given.
+  inline void RenderTile(
+    Tile const& tile,
+    Buffer2D<float>& data,
+    Engine const engine = Engine::Scalar,
+    KernelStats* stats = nullptr,
+    FrameReference const* reference = nullptr) {
+
+    if(data.Width() != tile.width || data.Height() != tile.height) {
+      data.Resize(tile.width, tile.height);
+    }
+
+    switch(tile.precision) {
+      case Precision::Float:
+        RenderTileAt<float>(tile, data, engine, stats);
+        break;
+      case Precision::Double:
+        RenderTileAt<double>(tile, data, engine, stats);
+        break;
+      case Precision::DoubleDouble:
+        RenderTileAt<DoubleDouble>(tile, data, engine, stats);
+        break;
+      case Precision::QuadDouble:
+      case Precision::FixedPoint:
+        if(reference != nullptr) {
+          RenderTilePerturbed(tile, data, *reference, stats);
+        } else {
+          RenderTilePerturbed(tile, data, FrameReference(tile), stats);
+        }
+        break;
+    }
+  }
+
+
+  // Copy a rendered tile into its place in a frame buffer
+  inline void CopyTileToFrame(Tile const& tile, Buffer2D<float>& data, Buffer2D<float>& frame) {
+    for(unsigned i = 0; i < tile.height; i++) {
+      std::copy(&data.Get(0, i), &data.Get(0, i) + tile.width, &frame.Get(tile.x, tile.y + i));
+    }
+  }
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_TILE_INCLUDED
@@ -0,0 +1,227 @@
+#ifndef MPIBROT_COMPUTE_TILEWORK_INCLUDED
+#define MPIBROT_COMPUTE_TILEWORK_INCLUDED
+
+
+// Internal
+#include "compute/Engine.hpp"
+#include "compute/KernelStats.hpp"
+#include "compute/ReferenceCache.hpp"
+#include "compute/Tile.hpp"
+#include "mpi/Transmissable.hpp"
+#include "mpi/error.hpp"
+#include "util/Buffer2D.hpp"
+#include "util/Queue.hpp"
+#include "util/Worker.hpp"
+
+// External
+#include "mpi.h"
+
+// Standard
+#include <cstring>
+#include <memory>
+#include <vector>
+
+
+namespace SimpleBrot {
+
+  // A tile to render, as scattered from the head rank to the workers
+  // Goes over the wire as one fixed size message.
+  class TileRequest : public mpi::Transmissable {
+  private:
+    typedef struct {
+      unsigned frame;
+      unsigned index;
+      double viewport[4][4];    // start.re, start.im, end.re, end.im
+      unsigned frameWidth;
+      unsigned frameHeight;
+      unsigned x;
+      unsigned y;
+      unsigned width;
+      unsigned height;
+      int precision;
+      unsigned maxIterations;
+      unsigned bailout;
+      unsigned supersampling;
+    }
+    Header;
+
+  public:
+    unsigned frame = 0;     // Frame the tile belongs to
+    unsigned index = 0;     // Position of the tile within its frame
+    Tile tile;
+
+    TileRequest() {}
+
+    TileRequest(unsigned const frame, unsigned const index, Tile const& tile) :
+      frame(frame), index(index), tile(tile) {}
+
+    void mpiSend(int const t_destination, int const t_tag, MPI_Comm const t_comm) const {
+      Header header;
+      header.frame = this->frame;
+      header.index = this->index;
+      std::memcpy(header.viewport[0], this->tile.start.real().x, sizeof(header.viewport[0]));
+      std::memcpy(header.viewport[1], this->tile.start.imag().x, sizeof(header.viewport[1]));
+      std::memcpy(header.viewport[2], this->tile.end.real().x, sizeof(header.viewport[2]));
+      std::memcpy(header.viewport[3], this->tile.end.imag().x, sizeof(header.viewport[3]));
+      header.frameWidth = this->tile.frameWidth;
+      header.frameHeight = this->tile.frameHeight;
+      header.x = this->tile.x;
+      header.y = this->tile.y;
+      header.width = this->tile.width;
+      header.height = this->tile.height;
+      header.precision = static_cast<int>(this->tile.precision);
+      header.maxIterations = this->tile.maxIterations;
+      header.bailout = this->tile.bailout;
+      header.supersampling = this->tile.supersampling;
+
+      mpi::error::check(MPI_Send(&header, sizeof(Header), MPI_BYTE, t_destination, t_tag, t_comm));
+    }
+
+    void mpiReceive(int const t_source, int const t_tag, MPI_Comm const t_comm) {
+      Header header;
+      mpi::error::check(MPI_Recv(&header, sizeof(Header), MPI_BYTE, t_source, t_tag, t_comm, MPI_STATUS_IGNORE));
+
+      auto const quad = [](double const* x) {return QuadDouble(x[0], x[1], x[2], x[3]);};
+
+      this->frame = header.frame;
+      this->index = header.index;
+      this->tile.start = std::complex<QuadDouble>(quad(header.viewport[0]), quad(header.viewport[1]));
+      this->tile.end = std::complex<QuadDouble>(quad(header.viewport[2]), quad(header.viewport[3]));
+      this->tile.frameWidth = header.frameWidth;
+      this->tile.frameHeight = header.frameHeight;
+      this->tile.x = header.x;
+      this->tile.y = header.y;
+      this->tile.width = header.width;
+      this->tile.height = header.height;
+      this->tile.precision = static_cast<Precision>(header.precision);
+      this->tile.maxIterations = header.maxIterations;
+      this->tile.bailout = header.bailout;
+      this->tile.supersampling = header.supersampling;
+    }
+  };
+
+
+  // A rendered tile, as gathered from the workers back to the head rank
+  // Goes over the wire as one message, a header followed by the values.
+  class TileResult : public mpi::Transmissable {
+  private:
+    typedef struct {
+      unsigned frame;
+      unsigned index;
+      unsigned x;
+      unsigned y;
+      unsigned width;
+      unsigned height;
+      KernelStats stats;
+    }
+    Header;
+
+  public:
+    unsigned frame = 0;
+    unsigned index = 0;
+    unsigned x = 0;           // Pixel rectangle within the frame
+    unsigned y = 0;
+    unsigned width = 0;
+    unsigned height = 0;
+    KernelStats stats;
+    std::vector<float> values;  // Continuous iteration counts, row major
+
+    TileResult() {}
+
+    // Take the rendered values of a tile
+    TileResult(TileRequest const& request, Buffer2D<float>& data, KernelStats const& stats) :
+      frame(request.frame), index(request.index),
+      x(request.tile.x), y(request.tile.y),
+      width(request.tile.width), height(request.tile.height),
+      stats(stats),
+      values(&data.Get(0, 0), &data.Get(0, 0) + request.tile.width * request.tile.height) {}
+
+    float Get(unsigned const j, unsigned const i) const {return this->values[i * this->width + j];}
+
+    void mpiSend(int const t_destination, int const t_tag, MPI_Comm const t_comm) const {
+      Header const header = {
+        this->frame, this->index, this->x, this->y, this->width, this->height, this->stats
+      };
+
+      size_t const payload = this->values.size() * sizeof(float);
+      std::vector<char> buffer(sizeof(Header) + payload);
+      std::memcpy(buffer.data(), &header, sizeof(Header));
+      std::memcpy(buffer.data() + sizeof(Header), this->values.data(), payload);
+
+      mpi::error::check(MPI_Send(buffer.data(), buffer.size(), MPI_BYTE, t_destination, t_tag, t_comm));
+    }
+
+    void mpiReceive(int const t_source, int const t_tag, MPI_Comm const t_comm) {
+      MPI_Status status;
+      int count = 0;
+      mpi::error::check(MPI_Probe(t_source, t_tag, t_comm, &status));
+      mpi::error::check(MPI_Get_count(&status, MPI_BYTE, &count));
+
+      std::vector<char> buffer(count);
+      mpi::error::check(MPI_Recv(buffer.data(), count, MPI_BYTE, t_source, t_tag, t_comm, MPI_STATUS_IGNORE));
+
+      Header header;
+      std::memcpy(&header, buffer.data(), sizeof(Header));
+      this->frame = header.frame;
+      this->index = header.index;
+      this->x = header.x;
+      this->y = header.y;
+      this->width = header.width;
+      this->height = header.height;
+      this->stats = header.stats;
+
+      this->values.resize(header.width * header.height);
+      std::memcpy(this->values.data(), buffer.data() + sizeof(Header), this->values.size() * sizeof(float));
+    }
+  };
+
+
+  // Renders tile requests from a queue into a queue of results
+  // Perturbed tiles take their frame's reference from a cache when given
+  // one, and build their own otherwise.
+  class TileWorker : public util::Worker<TileRequest> {
+  private:
+    std::shared_ptr<util::BoundedQueue<TileResult>> m_result_queue;
+    std::shared_ptr<ReferenceCache> m_references;
+    Engine const m_engine;
+
+    virtual void processWorkItem(TileRequest t_request) {
+      std::shared_ptr<FrameReference const> reference;
+
+      if(m_references != nullptr && IsPerturbed(t_request.tile.precision)) {
+        reference = m_references->lookup(t_request.frame);
+
+        // The frame was forgotten, nobody wants its tiles any more
+        if(reference == nullptr) {
+          return;
+        }
+      }
+
+      Buffer2D<float> data;
+      KernelStats stats;
+      RenderTile(t_request.tile, data, m_engine, &stats, reference.get());
+      m_result_queue->enqueue(TileResult(t_request, data, stats));
+    }
+
+  public:
+    TileWorker(
+      std::shared_ptr<util::BoundedQueue<TileRequest>> t_request_queue,
+      std::shared_ptr<util::BoundedQueue<TileResult>> t_result_queue,
+      unsigned const t_thread_count,
+      Engine const t_engine = Engine::Scalar,
+      std::shared_ptr<ReferenceCache> t_references = nullptr) :
+      Worker(t_request_queue, t_thread_count),
+      m_result_queue(t_result_queue),
+      m_references(t_references),
+      m_engine(t_engine) {}
+
+    // Queued tiles are rendered while the result queue still exists
+    ~TileWorker() {
+      this->stop();
+    }
+  };
+
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_TILEWORK_INCLUDED
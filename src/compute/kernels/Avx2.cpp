@@ -0,0 +1,41 @@
+// Compiled with -mavx2, see ISA_FLAGS in the Makefile
+
+// Internal
+#include "compute/SimdKernel.hpp"
+#include "compute/simd/LaneKernel.hpp"
+#include "compute/simd/Avx2.hpp"
+#include "compute/simd/DoubleDoubleLanes.hpp"
+
+
+namespace SimpleBrot {
+  namespace Simd {
+
+    void FillIterationRowAvx2(
+      unsigned* row, unsigned const width,
+      float const re0, float const rStep, float const im,
+      unsigned const maxIterations, unsigned const bailout,
+      float const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn) {
+      FillIterationRow<Avx2Float>(row, width, re0, rStep, im, maxIterations, bailout, periodicityTolerance, stats, smooth, distance, firstColumn);
+    }
+
+    void FillIterationRowAvx2(
+      unsigned* row, unsigned const width,
+      double const re0, double const rStep, double const im,
+      unsigned const maxIterations, unsigned const bailout,
+      double const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn) {
+      FillIterationRow<Avx2Double>(row, width, re0, rStep, im, maxIterations, bailout, periodicityTolerance, stats, smooth, distance, firstColumn);
+    }
+
+    void FillIterationRowAvx2(
+      unsigned* row, unsigned const width,
+      DoubleDouble const re0, DoubleDouble const rStep, DoubleDouble const im,
+      unsigned const maxIterations, unsigned const bailout,
+      DoubleDouble const periodicityTolerance, KernelStats* stats, float* smooth, float* distance,
+      unsigned const firstColumn) {
+      FillIterationRow<DoubleDoubleLanes<Avx2Double>>(row, width, re0, rStep, im, maxIterations, bailout, periodicityTolerance, stats, smooth, distance, firstColumn);
+    }
+
+  } // namespace Simd
+} // namespace SimpleBrot
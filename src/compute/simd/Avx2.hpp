@@ -0,0 +1,115 @@
+#ifndef MPIBROT_COMPUTE_SIMD_AVX2_INCLUDED
+#define MPIBROT_COMPUTE_SIMD_AVX2_INCLUDED
+
+
+// Standard
+#include <immintrin.h>
+
+
+#ifndef __AVX2__
+#error "compute/simd/Avx2.hpp must be compiled with AVX2 enabled"
+#endif
+
+
+namespace SimpleBrot {
+  namespace Simd {
+
+    // 8 single precision lanes, masks are all-ones float lanes
+    struct Avx2Float {
+      typedef float Scalar;
+      typedef __m256 Vec;
+      typedef __m256 Mask;
+      typedef __m256i Count;
+      static unsigned const Lanes = 8;
+
+      static inline Vec Zero() {return _mm256_setzero_ps();}
+      static inline Vec Set1(Scalar const x) {return _mm256_set1_ps(x);}
+      static inline Vec Add(Vec const a, Vec const b) {return _mm256_add_ps(a, b);}
+      static inline Vec Sub(Vec const a, Vec const b) {return _mm256_sub_ps(a, b);}
+      static inline Vec Mul(Vec const a, Vec const b) {return _mm256_mul_ps(a, b);}
+      static inline Vec Square(Vec const a) {return Mul(a, a);}
+      static inline void StoreLanes(Scalar* out, Vec const v) {_mm256_storeu_ps(out, v);}
+
+      // Column indices j, j + 1, ... j + 7
+      static inline Vec Columns(unsigned const j) {
+        return _mm256_cvtepi32_ps(_mm256_add_epi32(
+          _mm256_set1_epi32(j), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+      }
+
+      static inline Mask NoLanes() {return _mm256_setzero_ps();}
+      static inline Mask AllLanes() {return _mm256_castsi256_ps(_mm256_set1_epi32(-1));}
+      static inline Mask Less(Vec const a, Vec const b) {return _mm256_cmp_ps(a, b, _CMP_LT_OQ);}
+      static inline Mask LessEqual(Vec const a, Vec const b) {return _mm256_cmp_ps(a, b, _CMP_LE_OQ);}
+      static inline Mask Equal(Vec const a, Vec const b) {return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);}
+      static inline Mask Or(Mask const a, Mask const b) {return _mm256_or_ps(a, b);}
+      static inline Mask AndNot(Mask const a, Mask const b) {return _mm256_andnot_ps(b, a);}
+      static inline unsigned Bits(Mask const m) {return _mm256_movemask_ps(m);}
+      static inline Mask And(Mask const a, Mask const b) {return _mm256_and_ps(a, b);}
+      static inline bool None(Mask const m) {return _mm256_movemask_ps(m) == 0;}
+      static inline Vec Select(Mask const m, Vec const a, Vec const b) {return _mm256_blendv_ps(b, a, m);}
+
+      // Active lanes hold -1, so subtracting the mask adds one
+      static inline Count ZeroCount() {return _mm256_setzero_si256();}
+      static inline Count Increment(Count const c, Mask const m) {
+        return _mm256_sub_epi32(c, _mm256_castps_si256(m));
+      }
+
+      static inline void Store(unsigned* out, Count const c, unsigned const lanes) {
+        alignas(32) unsigned buffer[Lanes];
+        _mm256_store_si256((__m256i*)buffer, c);
+        for(unsigned i = 0; i < lanes; i++) out[i] = buffer[i];
+      }
+    };
+
+
+    // 4 double precision lanes, masks are all-ones double lanes
+    struct Avx2Double {
+      typedef double Scalar;
+      typedef __m256d Vec;
+      typedef __m256d Mask;
+      typedef __m256i Count;
+      static unsigned const Lanes = 4;
+
+      static inline Vec Zero() {return _mm256_setzero_pd();}
+      static inline Vec Set1(Scalar const x) {return _mm256_set1_pd(x);}
+      static inline Vec Add(Vec const a, Vec const b) {return _mm256_add_pd(a, b);}
+      static inline Vec Sub(Vec const a, Vec const b) {return _mm256_sub_pd(a, b);}
+      static inline Vec Mul(Vec const a, Vec const b) {return _mm256_mul_pd(a, b);}
+      static inline Vec Square(Vec const a) {return Mul(a, a);}
+      static inline void StoreLanes(Scalar* out, Vec const v) {_mm256_storeu_pd(out, v);}
+
+      static inline Vec Columns(unsigned const j) {
+        return _mm256_cvtepi32_pd(_mm_add_epi32(
+          _mm_set1_epi32(j), _mm_setr_epi32(0, 1, 2, 3)));
+      }
+
+      static inline Mask NoLanes() {return _mm256_setzero_pd();}
+      static inline Mask AllLanes() {return _mm256_castsi256_pd(_mm256_set1_epi64x(-1));}
+      static inline Mask Less(Vec const a, Vec const b) {return _mm256_cmp_pd(a, b, _CMP_LT_OQ);}
+      static inline Mask LessEqual(Vec const a, Vec const b) {return _mm256_cmp_pd(a, b, _CMP_LE_OQ);}
+      static inline Mask Equal(Vec const a, Vec const b) {return _mm256_cmp_pd(a, b, _CMP_EQ_OQ);}
+      static inline Mask Or(Mask const a, Mask const b) {return _mm256_or_pd(a, b);}
+      static inline Mask AndNot(Mask const a, Mask const b) {return _mm256_andnot_pd(b, a);}
+      static inline unsigned Bits(Mask const m) {return _mm256_movemask_pd(m);}
+      static inline Mask And(Mask const a, Mask const b) {return _mm256_and_pd(a, b);}
+      static inline bool None(Mask const m) {return _mm256_movemask_pd(m) == 0;}
+      static inline Vec Select(Mask const m, Vec const a, Vec const b) {return _mm256_blendv_pd(b, a, m);}
+
+      // 64 bit counters so the mask can be subtracted directly
+      static inline Count ZeroCount() {return _mm256_setzero_si256();}
+      static inline Count Increment(Count const c, Mask const m) {
+        return _mm256_sub_epi64(c, _mm256_castpd_si256(m));
+      }
+
+      static inline void Store(unsigned* out, Count const c, unsigned const lanes) {
+        alignas(32) unsigned long long buffer[Lanes];
+        _mm256_store_si256((__m256i*)buffer, c);
+        for(unsigned i = 0; i < lanes; i++) out[i] = buffer[i];
+      }
+    };
+
+  } // namespace Simd
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_SIMD_AVX2_INCLUDED
@@ -0,0 +1,113 @@
+#ifndef MPIBROT_COMPUTE_SIMD_AVX512_INCLUDED
+#define MPIBROT_COMPUTE_SIMD_AVX512_INCLUDED
+
+
+// Standard
+#include <immintrin.h>
+
+
+#ifndef __AVX512F__
+#error "compute/simd/Avx512.hpp must be compiled with AVX-512F enabled"
+#endif
+
+
+namespace SimpleBrot {
+  namespace Simd {
+
+    // 16 single precision lanes, masks are k registers
+    struct Avx512Float {
+      typedef float Scalar;
+      typedef __m512 Vec;
+      typedef __mmask16 Mask;
+      typedef __m512i Count;
+      static unsigned const Lanes = 16;
+
+      static inline Vec Zero() {return _mm512_setzero_ps();}
+      static inline Vec Set1(Scalar const x) {return _mm512_set1_ps(x);}
+      static inline Vec Add(Vec const a, Vec const b) {return _mm512_add_ps(a, b);}
+      static inline Vec Sub(Vec const a, Vec const b) {return _mm512_sub_ps(a, b);}
+      static inline Vec Mul(Vec const a, Vec const b) {return _mm512_mul_ps(a, b);}
+      static inline Vec Square(Vec const a) {return Mul(a, a);}
+      static inline void StoreLanes(Scalar* out, Vec const v) {_mm512_storeu_ps(out, v);}
+
+      // Built in float rather than converted, GCC 12 warns about the
+      // undefined passthrough operand of the 512 bit conversions at -O3
+      static inline Vec Columns(unsigned const j) {
+        return _mm512_add_ps(
+          _mm512_set1_ps(Scalar(j)),
+          _mm512_setr_ps(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+      }
+
+      static inline Mask NoLanes() {return 0;}
+      static inline Mask AllLanes() {return 0xffff;}
+      static inline Mask Less(Vec const a, Vec const b) {return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);}
+      static inline Mask LessEqual(Vec const a, Vec const b) {return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ);}
+      static inline Mask Equal(Vec const a, Vec const b) {return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);}
+      static inline Mask Or(Mask const a, Mask const b) {return a | b;}
+      static inline Mask AndNot(Mask const a, Mask const b) {return a & ~b;}
+      static inline unsigned Bits(Mask const m) {return m;}
+      static inline Mask And(Mask const a, Mask const b) {return a & b;}
+      static inline bool None(Mask const m) {return m == 0;}
+      static inline Vec Select(Mask const m, Vec const a, Vec const b) {return _mm512_mask_blend_ps(m, b, a);}
+
+      static inline Count ZeroCount() {return _mm512_setzero_si512();}
+      static inline Count Increment(Count const c, Mask const m) {
+        return _mm512_mask_add_epi32(c, m, c, _mm512_set1_epi32(1));
+      }
+
+      static inline void Store(unsigned* out, Count const c, unsigned const lanes) {
+        _mm512_mask_storeu_epi32(out, (__mmask16)((1u << lanes) - 1), c);
+      }
+    };
+
+
+    // 8 double precision lanes, masks are k registers
+    struct Avx512Double {
+      typedef double Scalar;
+      typedef __m512d Vec;
+      typedef __mmask8 Mask;
+      typedef __m512i Count;
+      static unsigned const Lanes = 8;
+
+      static inline Vec Zero() {return _mm512_setzero_pd();}
+      static inline Vec Set1(Scalar const x) {return _mm512_set1_pd(x);}
+      static inline Vec Add(Vec const a, Vec const b) {return _mm512_add_pd(a, b);}
+      static inline Vec Sub(Vec const a, Vec const b) {return _mm512_sub_pd(a, b);}
+      static inline Vec Mul(Vec const a, Vec const b) {return _mm512_mul_pd(a, b);}
+      static inline Vec Square(Vec const a) {return Mul(a, a);}
+      static inline void StoreLanes(Scalar* out, Vec const v) {_mm512_storeu_pd(out, v);}
+
+      static inline Vec Columns(unsigned const j) {
+        return _mm512_add_pd(
+          _mm512_set1_pd(Scalar(j)),
+          _mm512_setr_pd(0, 1, 2, 3, 4, 5, 6, 7));
+      }
+
+      static inline Mask NoLanes() {return 0;}
+      static inline Mask AllLanes() {return 0xff;}
+      static inline Mask Less(Vec const a, Vec const b) {return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ);}
+      static inline Mask LessEqual(Vec const a, Vec const b) {return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ);}
+      static inline Mask Equal(Vec const a, Vec const b) {return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);}
+      static inline Mask Or(Mask const a, Mask const b) {return a | b;}
+      static inline Mask AndNot(Mask const a, Mask const b) {return a & ~b;}
+      static inline unsigned Bits(Mask const m) {return m;}
+      static inline Mask And(Mask const a, Mask const b) {return a & b;}
+      static inline bool None(Mask const m) {return m == 0;}
+      static inline Vec Select(Mask const m, Vec const a, Vec const b) {return _mm512_mask_blend_pd(m, b, a);}
+
+      // 64 bit counters, narrowed to 32 bits on store
+      static inline Count ZeroCount() {return _mm512_setzero_si512();}
+      static inline Count Increment(Count const c, Mask const m) {
+        return _mm512_mask_add_epi64(c, m, c, _mm512_set1_epi64(1));
+      }
+
+      static inline void Store(unsigned* out, Count const c, unsigned const lanes) {
+        _mm512_mask_cvtepi64_storeu_epi32(out, (__mmask8)((1u << lanes) - 1), c);
+      }
+    };
+
+  } // namespace Simd
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_SIMD_AVX512_INCLUDED
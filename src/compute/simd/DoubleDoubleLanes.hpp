@@ -0,0 +1,79 @@
+#ifndef MPIBROT_COMPUTE_SIMD_DOUBLEDOUBLELANES_INCLUDED
+#define MPIBROT_COMPUTE_SIMD_DOUBLEDOUBLELANES_INCLUDED
+
+
+// Internal
+#include "compute/DoubleDouble.hpp"
+
+
+namespace SimpleBrot {
+  namespace Simd {
+
+    // Double-double lanes built on a double precision lane traits type D
+    // Presents the same interface as the lane traits so FillIterationRow runs
+    // unchanged, each Vec is a hi and a lo register pair. Arithmetic goes
+    // through DoubleDoubleArithmetic exactly as the scalar DoubleDouble does,
+    // and comparisons are exact, so results match the scalar path bit for bit.
+    template<class D>
+    struct DoubleDoubleLanes {
+      typedef DoubleDouble Scalar;
+      typedef typename DoubleDoubleArithmetic<D>::Value Vec;
+      typedef typename D::Mask Mask;
+      typedef typename D::Count Count;
+      static unsigned const Lanes = D::Lanes;
+
+      typedef DoubleDoubleArithmetic<D> Arithmetic;
+
+      static inline Vec Zero() {return {D::Zero(), D::Zero()};}
+      static inline Vec Set1(Scalar const x) {return {D::Set1(x.hi), D::Set1(x.lo)};}
+      static inline Vec Add(Vec const a, Vec const b) {return Arithmetic::Add(a, b);}
+      static inline Vec Sub(Vec const a, Vec const b) {return Arithmetic::Sub(a, b);}
+      static inline Vec Mul(Vec const a, Vec const b) {return Arithmetic::Mul(a, b);}
+      static inline Vec Square(Vec const a) {return Arithmetic::Square(a);}
+      static inline Vec Columns(unsigned const j) {return {D::Columns(j), D::Zero()};}
+
+      static inline void StoreLanes(Scalar* out, Vec const v) {
+        double hi[Lanes];
+        double lo[Lanes];
+        D::StoreLanes(hi, v.hi);
+        D::StoreLanes(lo, v.lo);
+        for(unsigned l = 0; l < Lanes; l++) {
+          out[l] = DoubleDouble(hi[l], lo[l]);
+        }
+      }
+
+      static inline Mask NoLanes() {return D::NoLanes();}
+      static inline Mask AllLanes() {return D::AllLanes();}
+
+      static inline Mask Less(Vec const a, Vec const b) {
+        return D::Or(D::Less(a.hi, b.hi), D::And(D::Equal(a.hi, b.hi), D::Less(a.lo, b.lo)));
+      }
+
+      static inline Mask LessEqual(Vec const a, Vec const b) {
+        return D::Or(D::Less(a.hi, b.hi), D::And(D::Equal(a.hi, b.hi), D::LessEqual(a.lo, b.lo)));
+      }
+
+      static inline Mask Equal(Vec const a, Vec const b) {
+        return D::And(D::Equal(a.hi, b.hi), D::Equal(a.lo, b.lo));
+      }
+
+      static inline Mask Or(Mask const a, Mask const b) {return D::Or(a, b);}
+      static inline Mask AndNot(Mask const a, Mask const b) {return D::AndNot(a, b);}
+      static inline unsigned Bits(Mask const m) {return D::Bits(m);}
+      static inline Mask And(Mask const a, Mask const b) {return D::And(a, b);}
+      static inline bool None(Mask const m) {return D::None(m);}
+
+      static inline Vec Select(Mask const m, Vec const a, Vec const b) {
+        return {D::Select(m, a.hi, b.hi), D::Select(m, a.lo, b.lo)};
+      }
+
+      static inline Count ZeroCount() {return D::ZeroCount();}
+      static inline Count Increment(Count const c, Mask const m) {return D::Increment(c, m);}
+      static inline void Store(unsigned* out, Count const c, unsigned const lanes) {D::Store(out, c, lanes);}
+    };
+
+  } // namespace Simd
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_SIMD_DOUBLEDOUBLELANES_INCLUDED
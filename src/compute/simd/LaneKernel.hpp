@@ -0,0 +1,211 @@
+#ifndef MPIBROT_COMPUTE_SIMD_LANEKERNEL_INCLUDED
+#define MPIBROT_COMPUTE_SIMD_LANEKERNEL_INCLUDED
+
+
+// Internal
+#include "compute/KernelStats.hpp"
+#include "compute/Escape.hpp"
+
+
+namespace SimpleBrot {
+  namespace Simd {
+
+    // Lanes whose c lies in the main cardioid or the period 2 bulb
+    // Same expressions and evaluation order as SimpleBrot::InMainCardioidOrBulb
+    template<class V>
+    typename V::Mask InMainCardioidOrBulb(
+      typename V::Vec const cr,
+      typename V::Vec const ci) {
+
+      typedef typename V::Vec Vec;
+
+      Vec const y2 = V::Mul(ci, ci);
+      Vec const xq = V::Sub(cr, V::Set1(0.25));
+      Vec const q = V::Add(V::Mul(xq, xq), y2);
+      Vec const xb = V::Add(cr, V::Set1(1));
+
+      return V::Or(
+        V::LessEqual(V::Mul(q, V::Add(q, xq)), V::Mul(V::Set1(0.25), y2)),
+        V::LessEqual(V::Add(V::Mul(xb, xb), y2), V::Set1(0.0625)));
+    }
+
+
+    // Escape time kernel over one row of pixels, V::Lanes orbits at a time
+    // V is one of the lane traits in compute/simd/, and this header must only
+    // be included from a translation unit compiled for V's instruction set.
+    // Lanes iterate in lock step, each lane's count stops advancing once it
+    // escapes and the whole group exits as soon as every lane has escaped.
+    // Periodicity checks follow the scalar schedule exactly: since every lane
+    // is on the same iteration, all lanes save their z at the same points.
+    // With smooth set, |z|^2 is captured as each lane escapes and turned into
+    // a continuous count the same way the scalar path does. With distance
+    // set, dz/dc is iterated alongside z and captured at escape as well.
+    template<class V>
+    void FillIterationRow(
+      unsigned* row,
+      unsigned const width,
+      typename V::Scalar const re0,
+      typename V::Scalar const rStep,
+      typename V::Scalar const im,
+      unsigned const maxIterations,
+      unsigned const bailout,
+      typename V::Scalar const periodicityTolerance,
+      KernelStats* stats,
+      float* smooth,
+      float* distance,
+      unsigned const firstColumn) {
+
+      typedef typename V::Scalar S;
+      typedef typename V::Vec Vec;
+      typedef typename V::Mask Mask;
+      typedef typename V::Count Count;
+
+      Vec const bailoutSquared = V::Set1(S(bailout) * S(bailout));
+      Vec const ci = V::Set1(im);
+
+      // Interior points only provably never escape for bailout >= 2
+      bool const shortCircuit = (bailout >= 2);
+
+      S const tolerance2 = periodicityTolerance * periodicityTolerance;
+      bool const checkPeriodicity = tolerance2 > S(0);
+      Vec const toleranceSquared = V::Set1(tolerance2);
+
+      bool const trackDerivative = (distance != nullptr);
+      bool const captureEscape = (smooth != nullptr) || trackDerivative;
+
+      for(unsigned j = 0; j < width; j += V::Lanes) {
+
+        // c.real() = re0 + rStep * column, same as the scalar path
+        Vec const cr = V::Add(V::Set1(re0), V::Mul(V::Set1(rStep), V::Columns(firstColumn + j)));
+
+        Vec zr = V::Zero();
+        Vec zi = V::Zero();
+        Count count = V::ZeroCount();
+        Mask active = V::AllLanes();
+
+        // Interior and periodic lanes sit out the loop and are patched on store
+        unsigned interior = 0;
+        Mask periodic = V::NoLanes();
+        if(shortCircuit) {
+          Mask const inside = InMainCardioidOrBulb<V>(cr, ci);
+          interior = V::Bits(inside);
+          active = V::AndNot(active, inside);
+        }
+
+        Vec escapedMagnitude = V::Zero();
+        Vec escapedZr = V::Zero();
+        Vec escapedZi = V::Zero();
+        Vec escapedDzr = V::Zero();
+        Vec escapedDzi = V::Zero();
+        Vec dzr = V::Zero();
+        Vec dzi = V::Zero();
+        Vec savedr = V::Zero();
+        Vec savedi = V::Zero();
+        unsigned checkpoint = 1;
+
+        for(unsigned k = 0; k < maxIterations; k++) {
+          Vec const zr2 = V::Square(zr);
+          Vec const zi2 = V::Square(zi);
+
+          Vec const magnitude = V::Add(zr2, zi2);
+          Mask const bounded = V::Less(magnitude, bailoutSquared);
+          if(captureEscape) {
+            Mask const escaping = V::AndNot(active, bounded);
+            escapedMagnitude = V::Select(escaping, magnitude, escapedMagnitude);
+            if(trackDerivative) {
+              escapedZr = V::Select(escaping, zr, escapedZr);
+              escapedZi = V::Select(escaping, zi, escapedZi);
+              escapedDzr = V::Select(escaping, dzr, escapedDzr);
+              escapedDzi = V::Select(escaping, dzi, escapedDzi);
+            }
+          }
+
+          active = V::And(active, bounded);
+          if(V::None(active)) {
+            break;
+          }
+
+          if(trackDerivative) {
+            Vec const tr = V::Sub(V::Mul(zr, dzr), V::Mul(zi, dzi));
+            Vec const ti = V::Add(V::Mul(zr, dzi), V::Mul(zi, dzr));
+            dzr = V::Add(V::Add(tr, tr), V::Set1(1));
+            dzi = V::Add(ti, ti);
+          }
+
+          zi = V::Add(V::Mul(V::Add(zr, zr), zi), ci);
+          zr = V::Add(V::Sub(zr2, zi2), cr);
+          count = V::Increment(count, active);
+
+          if(checkPeriodicity) {
+            Vec const dr = V::Sub(zr, savedr);
+            Vec const di = V::Sub(zi, savedi);
+            Mask const cycled = V::And(active,
+              V::LessEqual(V::Add(V::Square(dr), V::Square(di)), toleranceSquared));
+
+            periodic = V::Or(periodic, cycled);
+            active = V::AndNot(active, cycled);
+
+            if(k + 1 == checkpoint) {
+              savedr = zr;
+              savedi = zi;
+              checkpoint *= 2;
+            }
+          }
+        }
+
+        unsigned const lanes = (width - j) < V::Lanes ? (width - j) : V::Lanes;
+        V::Store(&row[j], count, lanes);
+
+        unsigned const laneBits = (1u << lanes) - 1;
+        interior &= laneBits;
+        unsigned const cycles = V::Bits(periodic) & laneBits;
+
+        for(unsigned l = 0; l < lanes; l++) {
+          if((interior | cycles) & (1u << l)) {
+            row[j + l] = maxIterations;
+          }
+        }
+
+        if(smooth != nullptr) {
+          S magnitudes[V::Lanes];
+          V::StoreLanes(magnitudes, escapedMagnitude);
+          for(unsigned l = 0; l < lanes; l++) {
+            smooth[j + l] = SmoothIterationCount(row[j + l], ToDouble(magnitudes[l]), maxIterations, bailout);
+          }
+        }
+
+        // The distance estimate continues each orbit past the bailout, the
+        // lanes have diverged by now so that is done one lane at a time
+        if(distance != nullptr) {
+          S zrs[V::Lanes];
+          S zis[V::Lanes];
+          S dzrs[V::Lanes];
+          S dzis[V::Lanes];
+          V::StoreLanes(zrs, escapedZr);
+          V::StoreLanes(zis, escapedZi);
+          V::StoreLanes(dzrs, escapedDzr);
+          V::StoreLanes(dzis, escapedDzi);
+
+          for(unsigned l = 0; l < lanes; l++) {
+            EscapeState<S> escape;
+            escape.zr = zrs[l];
+            escape.zi = zis[l];
+            escape.dzr = dzrs[l];
+            escape.dzi = dzis[l];
+            distance[j + l] = DistanceEstimate(row[j + l], maxIterations, escape, re0 + (rStep * (firstColumn + j + l)), im);
+          }
+        }
+
+        if(stats != nullptr) {
+          stats->iteratedPixels += lanes;
+          stats->interiorShortCircuits += __builtin_popcount(interior);
+          stats->periodicExits += __builtin_popcount(cycles);
+        }
+      }
+    }
+
+  } // namespace Simd
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_SIMD_LANEKERNEL_INCLUDED
@@ -0,0 +1,112 @@
+#ifndef MPIBROT_COMPUTE_SIMD_SSE2_INCLUDED
+#define MPIBROT_COMPUTE_SIMD_SSE2_INCLUDED
+
+
+// Standard
+#include <emmintrin.h>
+
+
+#ifndef __SSE2__
+#error "compute/simd/Sse2.hpp must be compiled with SSE2 enabled"
+#endif
+
+
+namespace SimpleBrot {
+  namespace Simd {
+
+    // 4 single precision lanes, masks are all-ones float lanes
+    struct Sse2Float {
+      typedef float Scalar;
+      typedef __m128 Vec;
+      typedef __m128 Mask;
+      typedef __m128i Count;
+      static unsigned const Lanes = 4;
+
+      static inline Vec Zero() {return _mm_setzero_ps();}
+      static inline Vec Set1(Scalar const x) {return _mm_set1_ps(x);}
+      static inline Vec Add(Vec const a, Vec const b) {return _mm_add_ps(a, b);}
+      static inline Vec Sub(Vec const a, Vec const b) {return _mm_sub_ps(a, b);}
+      static inline Vec Mul(Vec const a, Vec const b) {return _mm_mul_ps(a, b);}
+      static inline Vec Square(Vec const a) {return Mul(a, a);}
+      static inline void StoreLanes(Scalar* out, Vec const v) {_mm_storeu_ps(out, v);}
+
+      static inline Vec Columns(unsigned const j) {
+        return _mm_cvtepi32_ps(_mm_add_epi32(
+          _mm_set1_epi32(j), _mm_setr_epi32(0, 1, 2, 3)));
+      }
+
+      static inline Mask NoLanes() {return _mm_setzero_ps();}
+      static inline Mask AllLanes() {return _mm_castsi128_ps(_mm_set1_epi32(-1));}
+      static inline Mask Less(Vec const a, Vec const b) {return _mm_cmplt_ps(a, b);}
+      static inline Mask LessEqual(Vec const a, Vec const b) {return _mm_cmple_ps(a, b);}
+      static inline Mask Equal(Vec const a, Vec const b) {return _mm_cmpeq_ps(a, b);}
+      static inline Mask Or(Mask const a, Mask const b) {return _mm_or_ps(a, b);}
+      static inline Mask AndNot(Mask const a, Mask const b) {return _mm_andnot_ps(b, a);}
+      static inline unsigned Bits(Mask const m) {return _mm_movemask_ps(m);}
+      static inline Mask And(Mask const a, Mask const b) {return _mm_and_ps(a, b);}
+      static inline bool None(Mask const m) {return _mm_movemask_ps(m) == 0;}
+      static inline Vec Select(Mask const m, Vec const a, Vec const b) {return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));}
+
+      static inline Count ZeroCount() {return _mm_setzero_si128();}
+      static inline Count Increment(Count const c, Mask const m) {
+        return _mm_sub_epi32(c, _mm_castps_si128(m));
+      }
+
+      static inline void Store(unsigned* out, Count const c, unsigned const lanes) {
+        alignas(16) unsigned buffer[Lanes];
+        _mm_store_si128((__m128i*)buffer, c);
+        for(unsigned i = 0; i < lanes; i++) out[i] = buffer[i];
+      }
+    };
+
+
+    // 2 double precision lanes, masks are all-ones double lanes
+    struct Sse2Double {
+      typedef double Scalar;
+      typedef __m128d Vec;
+      typedef __m128d Mask;
+      typedef __m128i Count;
+      static unsigned const Lanes = 2;
+
+      static inline Vec Zero() {return _mm_setzero_pd();}
+      static inline Vec Set1(Scalar const x) {return _mm_set1_pd(x);}
+      static inline Vec Add(Vec const a, Vec const b) {return _mm_add_pd(a, b);}
+      static inline Vec Sub(Vec const a, Vec const b) {return _mm_sub_pd(a, b);}
+      static inline Vec Mul(Vec const a, Vec const b) {return _mm_mul_pd(a, b);}
+      static inline Vec Square(Vec const a) {return Mul(a, a);}
+      static inline void StoreLanes(Scalar* out, Vec const v) {_mm_storeu_pd(out, v);}
+
+      static inline Vec Columns(unsigned const j) {
+        return _mm_cvtepi32_pd(_mm_add_epi32(
+          _mm_set1_epi32(j), _mm_setr_epi32(0, 1, 0, 0)));
+      }
+
+      static inline Mask NoLanes() {return _mm_setzero_pd();}
+      static inline Mask AllLanes() {return _mm_castsi128_pd(_mm_set1_epi32(-1));}
+      static inline Mask Less(Vec const a, Vec const b) {return _mm_cmplt_pd(a, b);}
+      static inline Mask LessEqual(Vec const a, Vec const b) {return _mm_cmple_pd(a, b);}
+      static inline Mask Equal(Vec const a, Vec const b) {return _mm_cmpeq_pd(a, b);}
+      static inline Mask Or(Mask const a, Mask const b) {return _mm_or_pd(a, b);}
+      static inline Mask AndNot(Mask const a, Mask const b) {return _mm_andnot_pd(b, a);}
+      static inline unsigned Bits(Mask const m) {return _mm_movemask_pd(m);}
+      static inline Mask And(Mask const a, Mask const b) {return _mm_and_pd(a, b);}
+      static inline bool None(Mask const m) {return _mm_movemask_pd(m) == 0;}
+      static inline Vec Select(Mask const m, Vec const a, Vec const b) {return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));}
+
+      static inline Count ZeroCount() {return _mm_setzero_si128();}
+      static inline Count Increment(Count const c, Mask const m) {
+        return _mm_sub_epi64(c, _mm_castpd_si128(m));
+      }
+
+      static inline void Store(unsigned* out, Count const c, unsigned const lanes) {
+        alignas(16) unsigned long long buffer[Lanes];
+        _mm_store_si128((__m128i*)buffer, c);
+        for(unsigned i = 0; i < lanes; i++) out[i] = buffer[i];
+      }
+    };
+
+  } // namespace Simd
+} // namespace SimpleBrot
+
+
+#endif // MPIBROT_COMPUTE_SIMD_SSE2_INCLUDED
@@ -1,11 +1,40 @@
 // Internal
+#include "comm/AsyncConnection.hpp"
+#include "comm/Protocol.hpp"
+#include "compute/Dispatch.hpp"
+#include "compute/ReferenceBroadcaster.hpp"
+#include "compute/ReferenceCache.hpp"
+#include "compute/Tile.hpp"
+#include "compute/TileWork.hpp"
+#include "mpi/comm.hpp"
+#include "mpi/error.hpp"
+#include "util/Gatherer.hpp"
+#include "util/Queue.hpp"
+#include "util/Scatterer.hpp"
+#include "util/SpscQueue.hpp"
 
 // External
+#include "boost/asio.hpp"
 #include "optparse.hpp"
 #include "mpi.h"
 
 // Standard
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+
+using boost::asio::ip::tcp;
+
+
+// Rank that talks to clients, scatters tiles and gathers results
+#define MPIBROT_SERVER_HEAD_RANK 0
 
 
 // Server options
@@ -20,13 +49,499 @@ OptionParser genOptionParser(int argc, char** argv)
     "Port for server to listen on",
     {"9901"}));
 
+  opt.Add(Option(
+    "engine", 'e', ARG_TYPE_STRING,
+    "Iteration kernel: auto, scalar, sse2, avx2 or avx512",
+    {"auto"}));
+
+  opt.Add(Option(
+    "threads", 't', ARG_TYPE_INT,
+    "Worker threads per rank, 0 for one per core",
+    {"0"}));
+
+  opt.Add(Option(
+    "tile-size", 's', ARG_TYPE_INT,
+    "Width and height of the tiles frames are split into",
+    {"64"}));
+
+  opt.Add(Option(
+    "max-pixels", 'P', ARG_TYPE_INT,
+    "Largest frame, in pixels, a client may request",
+    {"16777216"}));
+
+  opt.Add(Option(
+    "max-supersampling", 'S', ARG_TYPE_INT,
+    "Largest supersampling factor a client may request",
+    {"8"}));
+
+  opt.Add(Option(
+    "max-iterations", 'i', ARG_TYPE_INT,
+    "Largest iteration limit a client may request",
+    {"1048576"}));
+
   return opt;
 }
 
 
+// Frames being rendered for all connected clients
+struct Server
+{
+  struct Frame
+  {
+    std::shared_ptr<comm::AsyncConnection> client;
+    unsigned clientFrame;
+    unsigned tileCount;
+    unsigned remaining;
+    bool perturbed;                                 // Has a broadcast reference
+    SimpleBrot::KernelStats stats;
+    std::chrono::steady_clock::time_point requested;
+  };
+
+  comm::FrameLimits limits;                         // Set before serving
+  SimpleBrot::ReferenceBroadcaster* references = nullptr;  // Set before serving
+
+  std::mutex mutex;
+  std::condition_variable pendingReady;
+  std::map<unsigned, Frame> frames;                 // Keyed by server frame id
+  std::list<SimpleBrot::TileRequest> pending;       // Tiles not yet scattered
+  unsigned nextFrame = 0;
+  bool stop = false;
+
+  // Forget a frame, caller holds the lock
+  std::map<unsigned, Frame>::iterator forgetFrame(std::map<unsigned, Frame>::iterator frame)
+  {
+    if(frame->second.perturbed)
+    {
+      references->forget(frame->first);
+    }
+
+    return frames.erase(frame);
+  }
+
+  // Whether a pending tile can be scattered now, caller holds the lock
+  // Tiles of clients that are not keeping up wait for their write queue to
+  // drain, which holds back only that client's frames.
+  bool feedable(SimpleBrot::TileRequest const& tile)
+  {
+    auto const frame = frames.find(tile.frame);
+    return frame == frames.end() || !frame->second.client->Backlogged();
+  }
+
+  // Forget the frames matching a predicate, caller holds the lock
+  template<class Predicate>
+  void forget(Predicate predicate)
+  {
+    for(auto frame = frames.begin(); frame != frames.end();)
+    {
+      if(predicate(frame->second))
+      {
+        frame = forgetFrame(frame);
+      }
+      else
+      {
+        frame++;
+      }
+    }
+  }
+};
+
+
+// Hand pending tiles to the scatterer, skipping those of cancelled frames
+// Tiles go over in batches of at most a queue's worth, so each batch costs
+// one claim on the queue, and as the request queues are short cancelling a
+// frame still stops most of it. Tiles of a backlogged client stay pending,
+// in order, until its connection drains, while other clients' tiles pass.
+void feedTiles(
+  std::shared_ptr<util::BoundedQueue<SimpleBrot::TileRequest>> requestQueue,
+  Server& server)
+{
+  std::vector<SimpleBrot::TileRequest> batch;
+
+  while(1)
+  {
+    std::unique_lock<std::mutex> lock(server.mutex);
+    server.pendingReady.wait(lock, [&server]
+    {
+      if(server.stop)
+      {
+        return true;
+      }
+
+      for(SimpleBrot::TileRequest const& tile : server.pending)
+      {
+        if(server.feedable(tile))
+        {
+          return true;
+        }
+      }
+
+      return false;
+    });
+
+    if(server.stop)
+    {
+      break;
+    }
+
+    batch.clear();
+
+    for(auto tile = server.pending.begin(); tile != server.pending.end() && batch.size() < requestQueue->size();)
+    {
+      if(!server.feedable(*tile))
+      {
+        tile++;
+        continue;
+      }
+
+      if(server.frames.count(tile->frame) != 0)
+      {
+        batch.push_back(*tile);
+      }
+
+      tile = server.pending.erase(tile);
+    }
+
+    lock.unlock();
+    requestQueue->enqueueBatch(std::move(batch));
+  }
+}
+
+
+// Send gathered tiles back to the clients that asked for them
+// Tiles of cancelled frames, or frames whose client has gone, are dropped.
+// One thread serves every client so sending never blocks. Results are always
+// queued, a client that is slow to read is throttled by feedTiles holding
+// back its tiles, so its queue grows past the cap by at most the tiles that
+// were already in the pipeline, and it never stalls the others or, through
+// the result queue, the workers.
+void streamResults(
+  std::shared_ptr<util::BoundedQueue<SimpleBrot::TileResult>> resultQueue,
+  Server& server)
+{
+  while(1)
+  {
+    boost::optional<SimpleBrot::TileResult> gathered = resultQueue->dequeue();
+
+    if(!gathered)
+    {
+      break;
+    }
+
+    SimpleBrot::TileResult& result = *gathered;
+
+    std::shared_ptr<comm::AsyncConnection> client;
+    comm::TileHeader header;
+    comm::Stats stats;
+    bool complete = false;
+
+    {
+      std::lock_guard<std::mutex> lock(server.mutex);
+
+      auto found = server.frames.find(result.frame);
+      if(found == server.frames.end())
+      {
+        continue;
+      }
+
+      Server::Frame& frame = found->second;
+      client = frame.client;
+
+      header = {
+        frame.clientFrame, result.index, frame.tileCount,
+        result.x, result.y, result.width, result.height
+      };
+
+      frame.stats.iteratedPixels += result.stats.iteratedPixels;
+      frame.stats.filledPixels += result.stats.filledPixels;
+      frame.stats.interiorShortCircuits += result.stats.interiorShortCircuits;
+      frame.stats.periodicExits += result.stats.periodicExits;
+      frame.stats.extraSamples += result.stats.extraSamples;
+
+      if(--frame.remaining == 0)
+      {
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - frame.requested;
+
+        stats = {
+          frame.clientFrame, frame.tileCount, elapsed.count(),
+          frame.stats.iteratedPixels, frame.stats.filledPixels,
+          frame.stats.interiorShortCircuits, frame.stats.periodicExits,
+          frame.stats.extraSamples
+        };
+
+        complete = true;
+        server.forgetFrame(found);
+      }
+    }
+
+    bool sent = client->QueueTile(header, std::make_shared<std::vector<float>>(std::move(result.values)));
+
+    if(sent && complete)
+    {
+      sent = client->Queue(stats);
+    }
+
+    // Only refused once the connection has closed
+    if(!sent)
+    {
+      std::lock_guard<std::mutex> lock(server.mutex);
+      server.forget([&](Server::Frame const& frame)
+      {
+        return frame.client == client;
+      });
+    }
+  }
+}
+
+
+// Act on a message from a client, called on the io thread
+void handleMessage(
+  Server& server,
+  std::shared_ptr<comm::AsyncConnection> client,
+  comm::MessageHeader const& header,
+  std::vector<char> const& body,
+  unsigned const tileSize)
+{
+  auto const quad = [](double const* x) {return SimpleBrot::QuadDouble(x[0], x[1], x[2], x[3]);};
+
+  if(header.type == comm::MessageType::FrameRequest)
+  {
+    comm::FrameRequest const request = comm::DecodeMessage<comm::FrameRequest>(header, body);
+    comm::ValidateFrameRequest(request, server.limits);
+
+    SimpleBrot::Tile const frame = SimpleBrot::FrameTile(
+      std::complex<SimpleBrot::QuadDouble>(quad(request.start[0]), quad(request.start[1])),
+      std::complex<SimpleBrot::QuadDouble>(quad(request.end[0]), quad(request.end[1])),
+      request.width, request.height,
+      request.maxIterations, request.bailout, request.supersampling);
+
+    std::vector<SimpleBrot::Tile> const tiles = SimpleBrot::SplitFrame(frame, tileSize, tileSize);
+
+    std::lock_guard<std::mutex> lock(server.mutex);
+    unsigned const id = server.nextFrame++;
+
+    Server::Frame& pending = server.frames[id];
+    pending.client = client;
+    pending.clientFrame = request.frame;
+    pending.tileCount = tiles.size();
+    pending.remaining = tiles.size();
+    pending.perturbed = SimpleBrot::IsPerturbed(frame.precision);
+    pending.requested = std::chrono::steady_clock::now();
+
+    // Published under the lock so references go out in frame id order
+    if(pending.perturbed)
+    {
+      server.references->publish(id, frame);
+    }
+
+    for(unsigned i = 0; i < tiles.size(); i++)
+    {
+      server.pending.push_back(SimpleBrot::TileRequest(id, i, tiles[i]));
+    }
+    server.pendingReady.notify_one();
+  }
+  else if(header.type == comm::MessageType::Cancel)
+  {
+    comm::Cancel const cancel = comm::DecodeMessage<comm::Cancel>(header, body);
+
+    std::lock_guard<std::mutex> lock(server.mutex);
+    server.forget([&](Server::Frame const& frame)
+    {
+      return frame.client == client && frame.clientFrame == cancel.frame;
+    });
+  }
+}
+
+
+// Accept clients for as long as the io service runs
+// Each client may have any number of frames in flight.
+void acceptClients(tcp::acceptor& acceptor, Server& server, unsigned const tileSize)
+{
+  std::shared_ptr<tcp::socket> socket(new tcp::socket(acceptor.get_executor()));
+
+  acceptor.async_accept(*socket, [&acceptor, &server, tileSize, socket](boost::system::error_code const& error)
+  {
+    if(error)
+    {
+      std::cerr << "ERROR, " << error.message() << "\n";
+      return;
+    }
+
+    socket->set_option(tcp::no_delay(true));
+    std::cout << "Client connected from " << socket->remote_endpoint() << "\n";
+
+    std::shared_ptr<comm::AsyncConnection> client(new comm::AsyncConnection(std::move(*socket)));
+    std::weak_ptr<comm::AsyncConnection> weakClient(client);
+
+    client->Start(
+      [&server, weakClient, tileSize](comm::MessageHeader const& header, std::vector<char> const& body)
+      {
+        std::shared_ptr<comm::AsyncConnection> client = weakClient.lock();
+        try
+        {
+          handleMessage(server, client, header, body, tileSize);
+        }
+        catch(std::exception const& e)
+        {
+          std::cerr << "Bad message from client, " << e.what() << "\n";
+          client->Close();
+        }
+      },
+      [&server, weakClient](boost::system::error_code const& error)
+      {
+        std::cout << "Client disconnected, " << error.message() << "\n";
+
+        std::shared_ptr<comm::AsyncConnection> client = weakClient.lock();
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.forget([&](Server::Frame const& frame)
+        {
+          return frame.client == client;
+        });
+      },
+      [&server]()
+      {
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.pendingReady.notify_one();
+      });
+
+    acceptClients(acceptor, server, tileSize);
+  });
+}
+
+
 int main(int argc, char** argv)
 {
   OptionParser opt = genOptionParser(argc, argv);
-  std::cout << "Hello world\n";
+
+  // Pick the widest kernel this node supports unless told otherwise
+  SimpleBrot::Engine engine;
+  try
+  {
+    std::string engineName = opt.Get("engine");
+    engine = SimpleBrot::SelectEngine(engineName);
+  }
+  catch(std::exception const& e)
+  {
+    std::cerr << "ERROR, " << e.what() << "\n";
+    exit(1);
+  }
+
+  int port = opt.Get("port");
+  int threads = opt.Get("threads");
+  int tileSize = opt.Get("tile-size");
+  int maxPixels = opt.Get("max-pixels");
+  int maxSupersampling = opt.Get("max-supersampling");
+  int maxIterations = opt.Get("max-iterations");
+
+  if(threads <= 0)
+  {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  if(tileSize <= 0)
+  {
+    std::cerr << "ERROR, Tile size must be positive\n";
+    exit(1);
+  }
+
+  if(maxPixels <= 0 || maxSupersampling <= 0 || maxIterations <= 0)
+  {
+    std::cerr << "ERROR, Frame limits must be positive\n";
+    exit(1);
+  }
+
+  // Scatterer, worker and gatherer all run threads that use MPI
+  int threadLevelRequired = MPI_THREAD_MULTIPLE;
+  int threadLevelActual;
+  mpi::error::check(MPI_Init_thread(&argc, &argv, threadLevelRequired, &threadLevelActual));
+
+  if(threadLevelActual != threadLevelRequired)
+  {
+    std::cerr << "ERROR, Could not initialise threaded MPI environment\n";
+    exit(1);
+  }
+
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  int rank = mpi::comm::rank(communicator);
+  bool head = (rank == MPIBROT_SERVER_HEAD_RANK);
+
+  std::cout << "Rank " << rank << " using " << SimpleBrot::EngineName(engine);
+  std::cout << " engine with " << threads << " threads\n";
+
+  {
+    // Request queues are kept short so ranks pull tiles as they free up
+    unsigned requestQueueLength = 2 * threads;
+    unsigned queueLength = 1024;
+
+    std::shared_ptr<util::BoundedQueue<SimpleBrot::TileRequest>> requestQueue(nullptr);
+    std::shared_ptr<util::Queue<SimpleBrot::TileRequest>> localRequestQueue(new util::Queue<SimpleBrot::TileRequest>(requestQueueLength));
+
+    std::shared_ptr<util::Queue<SimpleBrot::TileResult>> localResultQueue(new util::Queue<SimpleBrot::TileResult>(queueLength));
+    std::shared_ptr<util::Queue<SimpleBrot::TileResult>> resultQueue(nullptr);
+
+    // The head's request queue only has the feed thread on one end and the
+    // scatterer's single transmit thread on the other
+    if(head)
+    {
+      requestQueue = std::shared_ptr<util::BoundedQueue<SimpleBrot::TileRequest>>(new util::SpscQueue<SimpleBrot::TileRequest>(requestQueueLength));
+      resultQueue = std::shared_ptr<util::Queue<SimpleBrot::TileResult>>(new util::Queue<SimpleBrot::TileResult>(queueLength));
+    }
+
+    // Deep frames share one reference per frame, built on the head rank
+    std::shared_ptr<SimpleBrot::ReferenceCache> references(new SimpleBrot::ReferenceCache());
+
+    // Every rank renders, only the head talks to clients
+    // Declared against the dataflow so they are destroyed along it, each
+    // stage closes its input and drains into the next before that one stops.
+    // References outlive the workers, which may still wait on them.
+    util::Gatherer<SimpleBrot::TileResult> gatherer(localResultQueue, resultQueue, communicator, MPIBROT_SERVER_HEAD_RANK);
+    SimpleBrot::ReferenceBroadcaster broadcaster(references, communicator, MPIBROT_SERVER_HEAD_RANK);
+    SimpleBrot::TileWorker worker(localRequestQueue, localResultQueue, threads, engine, references);
+    util::Scatterer<SimpleBrot::TileRequest> scatterer(requestQueue, localRequestQueue, communicator, MPIBROT_SERVER_HEAD_RANK);
+
+    if(head)
+    {
+      Server server;
+      server.limits.maxPixels = maxPixels;
+      server.limits.maxSupersampling = maxSupersampling;
+      server.limits.maxIterations = maxIterations;
+      server.references = &broadcaster;
+
+      std::thread feedThread(feedTiles, requestQueue, std::ref(server));
+      std::thread streamThread(streamResults, resultQueue, std::ref(server));
+
+      // Serve clients until the listening socket fails
+      try
+      {
+        boost::asio::io_service io;
+        tcp::acceptor acceptor(io, tcp::endpoint(tcp::v4(), port));
+        std::cout << "Listening on port " << port << "\n";
+
+        acceptClients(acceptor, server, tileSize);
+        io.run();
+      }
+      catch(boost::system::system_error const& e)
+      {
+        std::cerr << "ERROR, " << e.what() << "\n";
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(server.mutex);
+        server.stop = true;
+        server.frames.clear();
+        server.pendingReady.notify_one();
+      }
+
+      // Closing the queues releases the threads if they are blocked on them
+      requestQueue->close();
+      resultQueue->close();
+      feedThread.join();
+      streamThread.join();
+    }
+
+    // Other ranks keep rendering until the head stops serving
+    mpi::error::check(MPI_Barrier(communicator));
+  }
+
+  mpi::error::check(MPI_Finalize());
   return 0;
 }
@@ -0,0 +1,94 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/AdaptiveSupersample.hpp"
+#include "compute/SimpleBrot.hpp"
+
+// Standard
+#include <cmath>
+#include <complex>
+
+
+// Mean absolute difference between two buffers
+double meanDifference(Buffer2D<float>& a, Buffer2D<float>& b)
+{
+  double sum = 0;
+  for(unsigned i = 0; i < a.Height(); i++)
+  {
+    for(unsigned j = 0; j < a.Width(); j++)
+    {
+      sum += std::fabs(a.Get(j, i) - b.Get(j, i));
+    }
+  }
+  return sum / (a.Width() * a.Height());
+}
+
+
+SCENARIO(
+  "[Adaptive supersampling] - Only edges are supersampled")
+{
+  GIVEN("The default client view")
+  {
+    unsigned width = 160;
+    unsigned height = 120;
+    unsigned max_iterations = 64;
+    unsigned bailout = 2;
+    unsigned scale = 4;
+    float threshold = 1.0f;
+
+    std::complex<float> start(-2.5, -1.5);
+    std::complex<float> end(1.5, 1.5);
+
+    Buffer2D<float> single(width, height);
+    SimpleBrot::FillSmoothIterationBuffer(single, start, end, max_iterations, bailout);
+
+    SimpleBrot::KernelStats stats;
+    Buffer2D<float> adaptive(width, height);
+    SimpleBrot::ComputeAdaptiveIterations(
+      adaptive, start, end, max_iterations, bailout, scale, threshold, &stats);
+
+    THEN("Flat pixels keep their single sample and edges are refined")
+    {
+      unsigned long long edges = 0;
+      bool flat_unchanged = true;
+      for(unsigned i = 0; i < height; i++)
+      {
+        for(unsigned j = 0; j < width; j++)
+        {
+          if(SimpleBrot::IsEdge(single, j, i, threshold))
+          {
+            edges++;
+          }
+          else
+          {
+            flat_unchanged = flat_unchanged && (adaptive.Get(j, i) == single.Get(j, i));
+          }
+        }
+      }
+      REQUIRE(flat_unchanged == true);
+      REQUIRE(stats.extraSamples == edges * (scale * scale - 1));
+    }
+
+    THEN("Far fewer samples are taken than uniform supersampling")
+    {
+      REQUIRE(stats.extraSamples < (width * height * (scale * scale - 1)) / 2);
+    }
+
+    THEN("The result is closer to uniform supersampling than one sample")
+    {
+      Buffer2D<float> uniform(width, height);
+      SimpleBrot::ComputeSmoothIterations(uniform, start, end, max_iterations, bailout, scale);
+      REQUIRE(meanDifference(adaptive, uniform) < meanDifference(single, uniform) / 2);
+    }
+
+    THEN("Jittered subsamples are the same on every render")
+    {
+      Buffer2D<float> again(width, height);
+      SimpleBrot::ComputeAdaptiveIterations(
+        again, start, end, max_iterations, bailout, scale, threshold);
+      REQUIRE(meanDifference(adaptive, again) == 0);
+    }
+  }
+}
@@ -0,0 +1,162 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "comm/AsyncConnection.hpp"
+
+// External
+#include "boost/asio.hpp"
+
+// Standard
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+using boost::asio::ip::tcp;
+
+
+SCENARIO(
+  "[AsyncConnection] - A slow reader holds back its producer rather than being dropped")
+{
+  GIVEN("A connection with a small write queue to a reader that does not keep up")
+  {
+    unsigned const tiles = 256;
+    unsigned const side = 64;
+    size_t const tileBytes = sizeof(comm::MessageHeader) + sizeof(comm::TileHeader) + side * side * sizeof(float);
+    size_t const maxQueuedBytes = 4 * tileBytes;
+
+    boost::asio::io_service io;
+    tcp::acceptor acceptor(io, tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+
+    // Small socket buffers, so the queue rather than the kernel holds the backlog
+    tcp::socket reader(io);
+    reader.open(tcp::v4());
+    reader.set_option(boost::asio::socket_base::receive_buffer_size(4096));
+    reader.connect(acceptor.local_endpoint());
+
+    tcp::socket socket(io);
+    acceptor.accept(socket);
+    socket.set_option(boost::asio::socket_base::send_buffer_size(4096));
+
+    std::shared_ptr<comm::AsyncConnection> writer(new comm::AsyncConnection(std::move(socket), maxQueuedBytes));
+
+    std::mutex mutex;
+    std::condition_variable drained;
+    std::atomic<unsigned> drains(0);
+    std::atomic<bool> closed(false);
+
+    writer->Start(
+      [](comm::MessageHeader const&, std::vector<char> const&) {},
+      [&closed](boost::system::error_code const&) {closed = true;},
+      [&mutex, &drained, &drains]()
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        drains++;
+        drained.notify_all();
+      });
+
+    std::thread ioThread([&io] {io.run();});
+
+    WHEN("Tiles are only produced while the connection is not backlogged")
+    {
+      bool stalled = false;
+      bool finished = false;
+      size_t mostQueued = 0;
+      std::condition_variable progress;
+
+      // Stands in for the server feeding tiles of this client
+      std::thread producer([&]
+      {
+        for(unsigned i = 0; i < tiles; i++)
+        {
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            if(writer->Backlogged())
+            {
+              stalled = true;
+              progress.notify_all();
+            }
+
+            drained.wait(lock, [&writer] {return writer->Closed() || !writer->Backlogged();});
+          }
+
+          comm::TileHeader const header = {0, i, tiles, 0, 0, side, side};
+          std::shared_ptr<std::vector<float>> values(new std::vector<float>(side * side, float(i)));
+
+          if(!writer->QueueTile(header, values))
+          {
+            break;
+          }
+
+          std::lock_guard<std::mutex> lock(mutex);
+          mostQueued = std::max(mostQueued, writer->QueuedBytes());
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        progress.notify_all();
+      });
+
+      // Don't read anything until the producer has been held back
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        progress.wait(lock, [&] {return stalled || finished;});
+      }
+
+      std::vector<unsigned> received;
+      bool intact = true;
+
+      for(unsigned i = 0; i < tiles; i++)
+      {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+
+        comm::MessageHeader header;
+        boost::asio::read(reader, boost::asio::buffer(&header, sizeof(header)));
+
+        std::vector<char> body(header.length);
+        boost::asio::read(reader, boost::asio::buffer(body));
+
+        std::vector<float> values;
+        comm::TileHeader const tile = comm::DecodeTile(header, body, values);
+        received.push_back(tile.index);
+
+        for(float const value : values)
+        {
+          intact = intact && value == float(tile.index);
+        }
+      }
+
+      producer.join();
+      writer->Flush();
+
+      THEN("The producer waited for the queue to drain")
+      {
+        REQUIRE(stalled);
+        REQUIRE(drains > 0);
+        REQUIRE(mostQueued < maxQueuedBytes + tileBytes);
+      }
+
+      THEN("Every tile arrived, in order, and the connection stayed open")
+      {
+        REQUIRE(!closed);
+        REQUIRE(received.size() == tiles);
+        for(unsigned i = 0; i < received.size(); i++)
+        {
+          REQUIRE(received[i] == i);
+        }
+        REQUIRE(intact);
+      }
+    }
+
+    writer->Close();
+    ioThread.join();
+  }
+}
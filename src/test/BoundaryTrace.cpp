@@ -0,0 +1,56 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/BoundaryTrace.hpp"
+#include "compute/SimpleBrot.hpp"
+
+// Standard
+#include <complex>
+
+
+SCENARIO(
+  "[Boundary trace] - Tracing matches brute force")
+{
+  GIVEN("The default client view at an awkward resolution")
+  {
+    unsigned width = 211;
+    unsigned height = 157;
+    unsigned max_iterations = 256;
+    unsigned bailout = 2;
+
+    std::complex<double> start(-2.5, -1.5);
+    std::complex<double> end(1.5, 1.5);
+
+    WHEN("It is rendered by brute force and by boundary tracing")
+    {
+      Buffer2D<unsigned> brute(width, height);
+      SimpleBrot::FillIterationBuffer(brute, start, end, max_iterations, bailout);
+
+      SimpleBrot::KernelStats stats;
+      Buffer2D<unsigned> traced(width, height);
+      SimpleBrot::FillIterationBufferBoundaryTrace(
+        traced, start, end, max_iterations, bailout, &stats);
+
+      THEN("The buffers are identical")
+      {
+        bool buffers_match = true;
+        for(unsigned i = 0; i < height; i++)
+        {
+          for(unsigned j = 0; j < width; j++)
+          {
+            buffers_match = buffers_match && (brute.Get(j, i) == traced.Get(j, i));
+          }
+        }
+        REQUIRE(buffers_match == true);
+      }
+
+      THEN("Every pixel is accounted for and many were filled")
+      {
+        REQUIRE(stats.iteratedPixels + stats.filledPixels == width * height);
+        REQUIRE(stats.filledPixels > (width * height) / 4);
+      }
+    }
+  }
+}
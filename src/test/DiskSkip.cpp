@@ -0,0 +1,183 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/DiskSkip.hpp"
+#include "compute/Dispatch.hpp"
+#include "compute/SimpleBrot.hpp"
+
+// Standard
+#include <complex>
+
+
+SCENARIO(
+  "[Distance estimation] - Distance estimate channel")
+{
+  GIVEN("The default client view")
+  {
+    unsigned width = 149;
+    unsigned height = 97;
+    unsigned max_iterations = 256;
+    unsigned bailout = 2;
+
+    std::complex<double> start(-2.5, -1.5);
+    std::complex<double> end(1.5, 1.5);
+
+    Buffer2D<unsigned> counts(width, height);
+    Buffer2D<float> distance(width, height);
+    SimpleBrot::FillDistanceEstimateBuffer(counts, distance, start, end, max_iterations, bailout);
+
+    THEN("Interior pixels have no distance and exterior pixels do")
+    {
+      bool consistent = true;
+      for(unsigned i = 0; i < height; i++)
+      {
+        for(unsigned j = 0; j < width; j++)
+        {
+          bool const interior = (counts.Get(j, i) == max_iterations);
+          consistent = consistent && (interior == (distance.Get(j, i) == 0));
+        }
+      }
+      REQUIRE(consistent == true);
+    }
+
+    THEN("Distances shrink toward the set")
+    {
+      // Along the real axis right of the cardioid cusp at 0.25
+      float const near = SimpleBrot::ComputeDistanceEstimate(std::complex<double>(0.26, 0), 1024, 2);
+      float const far = SimpleBrot::ComputeDistanceEstimate(std::complex<double>(1.0, 0), 1024, 2);
+      REQUIRE(near > 0);
+      REQUIRE(near < far);
+    }
+
+    THEN("Every engine produces the same counts and distances")
+    {
+      for(SimpleBrot::Engine const engine : SimpleBrot::AllEngines())
+      {
+        if(SimpleBrot::EngineSupported(engine))
+        {
+          Buffer2D<unsigned> vectorisedCounts(width, height);
+          Buffer2D<float> vectorisedDistance(width, height);
+          SimpleBrot::FillDistanceEstimateBuffer(
+            vectorisedCounts, vectorisedDistance, start, end, max_iterations, bailout, engine);
+
+          unsigned matches = 0;
+          for(unsigned i = 0; i < height; i++)
+          {
+            for(unsigned j = 0; j < width; j++)
+            {
+              matches += (vectorisedCounts.Get(j, i) == counts.Get(j, i)) &&
+                         (vectorisedDistance.Get(j, i) == distance.Get(j, i));
+            }
+          }
+          REQUIRE(matches == width * height);
+        }
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Distance estimation] - Exterior disk skipping")
+{
+  GIVEN("The default client view and a view near the boundary")
+  {
+    unsigned width = 211;
+    unsigned height = 157;
+    unsigned max_iterations = 256;
+    unsigned bailout = 2;
+
+    std::complex<double> views[][2] = {
+      {{-2.5, -1.5}, {1.5, 1.5}},
+      {{-0.80, 0.05}, {-0.70, 0.15}}};
+
+    for(auto const& view : views)
+    {
+      Buffer2D<unsigned> brute(width, height);
+      Buffer2D<float> bruteDistance(width, height);
+      SimpleBrot::FillDistanceEstimateBuffer(brute, bruteDistance, view[0], view[1], max_iterations, bailout);
+
+      SimpleBrot::KernelStats stats;
+      Buffer2D<float> distance(width, height);
+      SimpleBrot::FillDistanceBufferDiskSkip(
+        distance, view[0], view[1], max_iterations, bailout, &stats);
+
+      THEN("No pixel of the set is filled as exterior")
+      {
+        bool interior_preserved = true;
+        for(unsigned i = 0; i < height; i++)
+        {
+          for(unsigned j = 0; j < width; j++)
+          {
+            bool const interior = (brute.Get(j, i) == max_iterations);
+            interior_preserved = interior_preserved && (interior == (distance.Get(j, i) == 0));
+          }
+        }
+        REQUIRE(interior_preserved == true);
+      }
+
+      THEN("Iterated pixels match a full distance render")
+      {
+        unsigned matches = 0;
+        for(unsigned i = 0; i < height; i++)
+        {
+          for(unsigned j = 0; j < width; j++)
+          {
+            matches += (distance.Get(j, i) == bruteDistance.Get(j, i));
+          }
+        }
+        REQUIRE(matches >= stats.iteratedPixels);
+      }
+
+      THEN("Every pixel is accounted for and some were skipped")
+      {
+        REQUIRE(stats.iteratedPixels + stats.filledPixels == width * height);
+        REQUIRE(stats.filledPixels > (width * height) / 10);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Distance estimation] - Disk skipping far from the set")
+{
+  GIVEN("Views whose disks dwarf the pixel spacing")
+  {
+    unsigned width = 32;
+    unsigned height = 24;
+    unsigned max_iterations = 64;
+    unsigned bailout = 2;
+
+    // Far out, and a view so small the disk spans ~1e300 pixels
+    std::complex<double> views[][2] = {
+      {{1e6, 1e6}, {1e6 + 4, 1e6 + 3}},
+      {{3.0, 3.0}, {3.0 + 4e-300, 3.0 + 3e-300}}};
+
+    for(auto const& view : views)
+    {
+      SimpleBrot::KernelStats stats;
+      Buffer2D<float> distance(width, height);
+      SimpleBrot::FillDistanceBufferDiskSkip(
+        distance, view[0], view[1], max_iterations, bailout, &stats);
+
+      THEN("One pixel is iterated and fills the rest of the view as exterior")
+      {
+        REQUIRE(stats.iteratedPixels == 1);
+        REQUIRE(stats.filledPixels == width * height - 1);
+
+        unsigned exterior = 0;
+        for(unsigned i = 0; i < height; i++)
+        {
+          for(unsigned j = 0; j < width; j++)
+          {
+            exterior += (distance.Get(j, i) > 0);
+          }
+        }
+        REQUIRE(exterior == width * height);
+      }
+    }
+  }
+}
@@ -0,0 +1,108 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/FixedPoint.hpp"
+#include "compute/Precision.hpp"
+#include "compute/ReferenceOrbit.hpp"
+
+// Standard
+#include <complex>
+#include <string>
+
+
+typedef SimpleBrot::FixedPoint<8> Fixed;
+
+
+// Exact value of a fixed point number
+SimpleBrot::HighPrecision<512> exactValue(Fixed const& t_value)
+{
+  Fixed const magnitude = t_value.Negative() ? -t_value : t_value;
+  SimpleBrot::HighPrecision<512> value = 0;
+  for(unsigned i = 8; i-- > 0;)
+  {
+    value = value * SimpleBrot::HighPrecision<512>(4294967296.0) + magnitude.limb[i];
+  }
+  value = ldexp(value, -int(Fixed::FractionBits));
+  return t_value.Negative() ? SimpleBrot::HighPrecision<512>(-value) : value;
+}
+
+
+SCENARIO(
+  "[Fixed point] - Fixed point arithmetic")
+{
+  GIVEN("Fixed point values with 224 fractional bits")
+  {
+    Fixed a = Fixed::Parse("-0.74364388703715870475219150611477");
+    Fixed b = Fixed(1.25) / Fixed(3);
+    SimpleBrot::HighPrecision<512> ulp = ldexp(SimpleBrot::HighPrecision<512>(1), -int(Fixed::FractionBits));
+
+    THEN("Doubles convert exactly and round trip")
+    {
+      REQUIRE(Fixed(-1.5).ToDouble() == -1.5);
+      REQUIRE(Fixed(0.1).ToDouble() == 0.1);
+      REQUIRE(Fixed(3) - Fixed(1) == Fixed(2));
+    }
+
+    THEN("Decimal strings parse past double precision")
+    {
+      SimpleBrot::HighPrecision<512> expected("-0.74364388703715870475219150611477");
+      REQUIRE(abs(exactValue(a) - expected) <= 2 * ulp);
+      REQUIRE(a < Fixed(-0.7436438870371587));
+      REQUIRE_THROWS(Fixed::Parse("0.5x"));
+    }
+
+    THEN("Products and quotients are accurate to the last limb")
+    {
+      SimpleBrot::HighPrecision<512> x = exactValue(a);
+      SimpleBrot::HighPrecision<512> y = exactValue(b);
+      REQUIRE(abs(exactValue(a * b) - x * y) <= ulp);
+      REQUIRE(abs(exactValue(b) - SimpleBrot::HighPrecision<512>(1.25) / 3) <= ulp);
+      REQUIRE(abs(exactValue(a - b) - (x - y)) == 0);
+    }
+
+    THEN("Square matches multiplying a value by itself exactly")
+    {
+      REQUIRE(Square(a) == a * a);
+      REQUIRE(Square(b) == b * b);
+      REQUIRE(Square(a - b) == (a - b) * (a - b));
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Fixed point] - Fixed point iteration")
+{
+  GIVEN("A view 1e-20 wide just outside the tip of the antenna at -2")
+  {
+    unsigned width = 16;
+    unsigned height = 16;
+    unsigned max_iterations = 2048;
+    unsigned bailout = 4;
+
+    SimpleBrot::QuadDouble width_re = SimpleBrot::QuadDouble(1e-20);
+    std::complex<SimpleBrot::QuadDouble> start(SimpleBrot::QuadDouble(-2) - width_re, -width_re / SimpleBrot::QuadDouble(2));
+    std::complex<SimpleBrot::QuadDouble> end(SimpleBrot::QuadDouble(-2), width_re / SimpleBrot::QuadDouble(2));
+
+    Buffer2D<unsigned> asQuadDouble(width, height);
+    Buffer2D<unsigned> asFixedPoint(width, height);
+
+    SimpleBrot::FillIterationBuffer(asQuadDouble, start, end, max_iterations, bailout, SimpleBrot::Precision::QuadDouble);
+    SimpleBrot::FillIterationBuffer(asFixedPoint, start, end, max_iterations, bailout, SimpleBrot::Precision::FixedPoint);
+
+    THEN("Fixed point agrees with quad-double")
+    {
+      unsigned matches = 0;
+      for(unsigned i = 0; i < height; i++)
+      {
+        for(unsigned j = 0; j < width; j++)
+        {
+          matches += (asQuadDouble.Get(j, i) == asFixedPoint.Get(j, i));
+        }
+      }
+      REQUIRE(matches >= (width * height * 95) / 100);
+    }
+  }
+}
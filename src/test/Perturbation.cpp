@@ -0,0 +1,151 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/Perturbation.hpp"
+#include "compute/SeriesApproximation.hpp"
+#include "compute/SimpleBrot.hpp"
+
+// Standard
+#include <cmath>
+#include <complex>
+#include <string>
+
+
+SCENARIO(
+  "[Perturbation] - Perturbed iteration counts match direct iteration")
+{
+  GIVEN("A view that double precision can still resolve")
+  {
+    unsigned width = 96;
+    unsigned height = 64;
+    unsigned max_iterations = 1024;
+    unsigned bailout = 2;
+
+    std::string center_re = "-0.743643887037151";
+    std::string center_im = "0.131825904205330";
+    std::complex<double> center(std::stod(center_re), std::stod(center_im));
+    std::complex<double> half_size(1.5e-6, 1e-6);
+
+    WHEN("It is rendered directly and by perturbation around its center")
+    {
+      Buffer2D<unsigned> direct(width, height);
+      SimpleBrot::FillIterationBuffer(
+        direct, center - half_size, center + half_size, max_iterations, bailout);
+
+      SimpleBrot::ReferenceOrbit orbit;
+      orbit.Compute(center_re, center_im, (2 * half_size.real()) / width, max_iterations, bailout);
+
+      Buffer2D<unsigned> perturbed(width, height);
+      SimpleBrot::FillIterationBufferPerturbed(
+        perturbed, orbit, -half_size, half_size, max_iterations, bailout);
+
+      THEN("Nearly all pixels agree")
+      {
+        unsigned matches = 0;
+        for(unsigned i = 0; i < height; i++)
+        {
+          for(unsigned j = 0; j < width; j++)
+          {
+            matches += (direct.Get(j, i) == perturbed.Get(j, i));
+          }
+        }
+
+        // Chaotic pixels on the boundary amplify last bit differences
+        REQUIRE(matches >= (width * height * 99) / 100);
+      }
+    }
+  }
+
+  GIVEN("A reference point that escapes quickly")
+  {
+    SimpleBrot::ReferenceOrbit orbit;
+    orbit.Compute("0.5", "0.5", 1e-3, 256, 2);
+
+    WHEN("A pixel inside the set is iterated relative to it")
+    {
+      unsigned rebases = 0;
+      unsigned count = SimpleBrot::ComputePerturbedIterationCount(
+        orbit, std::complex<double>(-0.5, -0.5), 256, 2, &rebases);
+
+      THEN("Rebasing carries it all the way to the iteration limit")
+      {
+        REQUIRE(orbit.Length() < 256);
+        REQUIRE(count == 256);
+        REQUIRE(rebases > 0);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Perturbation] - Series approximation skips early iterations")
+{
+  GIVEN("A deep view and its reference orbit")
+  {
+    unsigned width = 64;
+    unsigned height = 48;
+    unsigned max_iterations = 8192;
+    unsigned bailout = 2;
+
+    std::complex<double> half_size(4e-12, 3e-12);
+
+    SimpleBrot::ReferenceOrbit orbit;
+    orbit.Compute(
+      "-0.74364388703715870475219150", "0.13182590420531197049965025",
+      (2 * half_size.real()) / width, max_iterations, bailout);
+
+    WHEN("It is rendered with and without a series approximation")
+    {
+      SimpleBrot::SeriesApproximation series(
+        orbit, SimpleBrot::SeriesApproximation::ProbeView(-half_size, half_size), bailout);
+
+      Buffer2D<unsigned> plain(width, height);
+      SimpleBrot::FillIterationBufferPerturbed(
+        plain, orbit, -half_size, half_size, max_iterations, bailout);
+
+      Buffer2D<unsigned> skipped(width, height);
+      SimpleBrot::FillIterationBufferPerturbed(
+        skipped, orbit, -half_size, half_size, max_iterations, bailout, &series);
+
+      THEN("Iterations are skipped and nearly all pixels agree")
+      {
+        REQUIRE(series.Skip() > 0);
+
+        unsigned matches = 0;
+        for(unsigned i = 0; i < height; i++)
+        {
+          for(unsigned j = 0; j < width; j++)
+          {
+            matches += (plain.Get(j, i) == skipped.Get(j, i));
+          }
+        }
+        REQUIRE(matches >= (width * height * 99) / 100);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Perturbation] - Reference orbit working precision")
+{
+  GIVEN("Pixel spacings from coarse to unrepresentable")
+  {
+    THEN("Finer spacings need more bits")
+    {
+      REQUIRE(SimpleBrot::ReferenceOrbit::RequiredBits(1.0) == 64);
+      REQUIRE(SimpleBrot::ReferenceOrbit::RequiredBits(1e-30) > SimpleBrot::ReferenceOrbit::RequiredBits(1e-12));
+    }
+
+    THEN("Zero, negative and non-finite spacings ask for the most bits")
+    {
+      REQUIRE(SimpleBrot::ReferenceOrbit::RequiredBits(0.0) == 2048);
+      REQUIRE(SimpleBrot::ReferenceOrbit::RequiredBits(-1.0) == 2048);
+      REQUIRE(SimpleBrot::ReferenceOrbit::RequiredBits(std::nan("")) == 2048);
+      REQUIRE(SimpleBrot::ReferenceOrbit::RequiredBits(HUGE_VAL) == 2048);
+    }
+  }
+}
@@ -0,0 +1,164 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/Dispatch.hpp"
+#include "compute/Precision.hpp"
+#include "compute/ReferenceOrbit.hpp"
+
+// Standard
+#include <complex>
+#include <string>
+
+
+using SimpleBrot::DoubleDouble;
+using SimpleBrot::QuadDouble;
+using SimpleBrot::Precision;
+
+
+// Relative error of a value against a high precision reference
+template<class T>
+double relativeError(T const& t_value, SimpleBrot::HighPrecision<512> const& t_expected)
+{
+  SimpleBrot::HighPrecision<512> value = 0;
+  for(double const part : t_value.x)
+  {
+    value += part;
+  }
+  return abs((value - t_expected) / t_expected).template convert_to<double>();
+}
+
+double relativeError(DoubleDouble const& t_value, SimpleBrot::HighPrecision<512> const& t_expected)
+{
+  return relativeError(QuadDouble(t_value), t_expected);
+}
+
+
+// Count pixels on which two iteration buffers agree
+unsigned countMatches(Buffer2D<unsigned>& a, Buffer2D<unsigned>& b)
+{
+  unsigned matches = 0;
+  for(unsigned i = 0; i < a.Height(); i++)
+  {
+    for(unsigned j = 0; j < a.Width(); j++)
+    {
+      matches += (a.Get(j, i) == b.Get(j, i));
+    }
+  }
+  return matches;
+}
+
+
+SCENARIO(
+  "[Precision] - Double-double and quad-double arithmetic")
+{
+  GIVEN("Values that need more than 53 bits")
+  {
+    double const tiny = std::ldexp(1.0, -80);
+    SimpleBrot::HighPrecision<512> third = SimpleBrot::HighPrecision<512>(1) / 3;
+
+    THEN("Double-double keeps terms a double would round away")
+    {
+      DoubleDouble sum = DoubleDouble(1) + DoubleDouble(tiny);
+      REQUIRE((sum - DoubleDouble(1)) == DoubleDouble(tiny));
+    }
+
+    THEN("Double-double is accurate to about 106 bits")
+    {
+      DoubleDouble x = DoubleDouble(1) / DoubleDouble(3);
+      REQUIRE(relativeError(x, third) < 1e-31);
+      REQUIRE(relativeError(Square(x) * DoubleDouble(9), 1) < 1e-30);
+      REQUIRE(relativeError(x * x - x, third * third - third) < 1e-30);
+    }
+
+    THEN("Quad-double is accurate to about 212 bits")
+    {
+      QuadDouble x = QuadDouble(1) / QuadDouble(3);
+      REQUIRE(relativeError(x, third) < 1e-62);
+      REQUIRE(relativeError(x * x * QuadDouble(9), 1) < 1e-61);
+      REQUIRE(relativeError(x * x - x, third * third - third) < 1e-61);
+    }
+
+    THEN("Comparisons look past the leading double")
+    {
+      REQUIRE(DoubleDouble(1) < DoubleDouble(1) + DoubleDouble(tiny));
+      REQUIRE(QuadDouble(1) + QuadDouble(tiny) * QuadDouble(tiny) > QuadDouble(1));
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Precision] - Precision selection")
+{
+  GIVEN("Pixel spacings at increasing zoom")
+  {
+    THEN("The cheapest sufficient precision is chosen")
+    {
+      REQUIRE(SimpleBrot::SelectPrecision(4.0 / 1024) == Precision::Float);
+      REQUIRE(SimpleBrot::SelectPrecision(1e-6) == Precision::Double);
+      REQUIRE(SimpleBrot::SelectPrecision(1e-20) == Precision::DoubleDouble);
+      REQUIRE(SimpleBrot::SelectPrecision(1e-40) == Precision::QuadDouble);
+      REQUIRE(SimpleBrot::SelectPrecision(1e-100) == Precision::FixedPoint);
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Precision] - Deep views past double precision")
+{
+  GIVEN("A view 1e-20 wide just outside the tip of the antenna at -2")
+  {
+    unsigned width = 16;
+    unsigned height = 16;
+    unsigned max_iterations = 2048;
+    unsigned bailout = 4;
+
+    // Escape time varies with the distance past -2, which double can't
+    // represent at this zoom while the imaginary part near 0 is still exact
+    QuadDouble width_re = QuadDouble(1e-20);
+    std::complex<QuadDouble> start(QuadDouble(-2) - width_re, -width_re / QuadDouble(2));
+    std::complex<QuadDouble> end(QuadDouble(-2), width_re / QuadDouble(2));
+
+    Buffer2D<unsigned> asDouble(width, height);
+    Buffer2D<unsigned> asDoubleDouble(width, height);
+    Buffer2D<unsigned> asQuadDouble(width, height);
+
+    SimpleBrot::FillIterationBuffer(asDouble, start, end, max_iterations, bailout, Precision::Double);
+    SimpleBrot::FillIterationBuffer(asDoubleDouble, start, end, max_iterations, bailout, Precision::DoubleDouble);
+    SimpleBrot::FillIterationBuffer(asQuadDouble, start, end, max_iterations, bailout, Precision::QuadDouble);
+
+    THEN("Double-double agrees with quad-double where double does not")
+    {
+      unsigned const pixels = width * height;
+      REQUIRE(countMatches(asDoubleDouble, asQuadDouble) >= (pixels * 95) / 100);
+      REQUIRE(countMatches(asDouble, asQuadDouble) < (pixels * 50) / 100);
+    }
+  }
+
+  GIVEN("The same view rendered by each engine")
+  {
+    unsigned width = 37;
+    unsigned height = 9;
+    std::complex<QuadDouble> start(QuadDouble(-2) - QuadDouble(1e-25), QuadDouble(-1e-26));
+    std::complex<QuadDouble> end(QuadDouble(-2) + QuadDouble(1e-25), QuadDouble(1e-26));
+
+    Buffer2D<unsigned> scalar(width, height);
+    SimpleBrot::FillIterationBuffer(scalar, start, end, 1024, 2, Precision::DoubleDouble);
+
+    THEN("Vectorised double-double matches scalar double-double exactly")
+    {
+      for(SimpleBrot::Engine const engine : SimpleBrot::AllEngines())
+      {
+        if(SimpleBrot::EngineSupported(engine))
+        {
+          Buffer2D<unsigned> vectorised(width, height);
+          SimpleBrot::FillIterationBuffer(vectorised, start, end, 1024, 2, Precision::DoubleDouble, engine);
+          REQUIRE(countMatches(scalar, vectorised) == width * height);
+        }
+      }
+    }
+  }
+}
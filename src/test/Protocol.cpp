@@ -0,0 +1,214 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "comm/Protocol.hpp"
+
+// Standard
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+
+comm::FrameRequest genFrameRequest()
+{
+  comm::FrameRequest request = {};
+  request.start[0][0] = -2.0;
+  request.start[1][0] = -1.5;
+  request.end[0][0] = 1.0;
+  request.end[1][0] = 1.5;
+  request.width = 640;
+  request.height = 480;
+  request.maxIterations = 256;
+  request.bailout = 2;
+  request.supersampling = 1;
+  return request;
+}
+
+
+SCENARIO(
+  "[Protocol] - Frame requests outside the server limits are refused")
+{
+  GIVEN("Default limits and a request within them")
+  {
+    comm::FrameLimits const limits;
+    comm::FrameRequest const request = genFrameRequest();
+
+    THEN("The request is accepted")
+    {
+      REQUIRE_NOTHROW(comm::ValidateFrameRequest(request, limits));
+    }
+
+    WHEN("The frame is empty")
+    {
+      comm::FrameRequest empty_width = request;
+      empty_width.width = 0;
+      comm::FrameRequest empty_height = request;
+      empty_height.height = 0;
+
+      THEN("The request is refused")
+      {
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(empty_width, limits), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(empty_height, limits), std::runtime_error);
+      }
+    }
+
+    WHEN("The frame has more pixels than allowed, even when the product overflows 32 bits")
+    {
+      comm::FrameRequest large = request;
+      large.width = 65536;
+      large.height = 65536;
+
+      THEN("The request is refused")
+      {
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(large, limits), std::runtime_error);
+      }
+    }
+
+    WHEN("Supersampling, iteration limit or bailout are out of range")
+    {
+      comm::FrameRequest no_samples = request;
+      no_samples.supersampling = 0;
+      comm::FrameRequest many_samples = request;
+      many_samples.supersampling = limits.maxSupersampling + 1;
+      comm::FrameRequest no_iterations = request;
+      no_iterations.maxIterations = 0;
+      comm::FrameRequest many_iterations = request;
+      many_iterations.maxIterations = limits.maxIterations + 1;
+      comm::FrameRequest no_bailout = request;
+      no_bailout.bailout = 0;
+      comm::FrameRequest large_bailout = request;
+      large_bailout.bailout = limits.maxBailout + 1;
+
+      THEN("The request is refused")
+      {
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(no_samples, limits), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(many_samples, limits), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(no_iterations, limits), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(many_iterations, limits), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(no_bailout, limits), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(large_bailout, limits), std::runtime_error);
+      }
+    }
+
+    WHEN("The viewport is empty or not finite")
+    {
+      comm::FrameRequest empty = request;
+      empty.end[0][0] = empty.start[0][0];
+      comm::FrameRequest not_finite = request;
+      not_finite.end[1][2] = std::numeric_limits<double>::quiet_NaN();
+      comm::FrameRequest overflowing = request;
+      overflowing.start[0][0] = -std::numeric_limits<double>::max();
+      overflowing.end[0][0] = std::numeric_limits<double>::max();
+
+      THEN("The request is refused")
+      {
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(empty, limits), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(not_finite, limits), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(overflowing, limits), std::runtime_error);
+      }
+    }
+
+    WHEN("The viewport spans very little")
+    {
+      comm::FrameRequest subnormal = request;
+      subnormal.start[0][0] = 0;
+      subnormal.end[0][0] = std::numeric_limits<double>::denorm_min();
+      comm::FrameRequest below_min = request;
+      below_min.start[1][0] = 0;
+      below_min.end[1][0] = std::numeric_limits<double>::min() * (request.height / 2);
+      comm::FrameRequest deep = request;
+      deep.end[0][0] = deep.start[0][0];
+      deep.end[0][3] = 1e-300;
+
+      THEN("It is refused once a pixel spans less than a normal double")
+      {
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(subnormal, limits), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::ValidateFrameRequest(below_min, limits), std::runtime_error);
+      }
+
+      THEN("It is accepted while each pixel spans a normal double")
+      {
+        REQUIRE_NOTHROW(comm::ValidateFrameRequest(deep, limits));
+      }
+    }
+  }
+}
+
+
+std::vector<char> genTileBody(comm::TileHeader const& tile, unsigned const t_values)
+{
+  std::vector<char> body(sizeof(comm::TileHeader) + t_values * sizeof(float));
+  std::memcpy(body.data(), &tile, sizeof(comm::TileHeader));
+
+  for(unsigned i = 0; i < t_values; i++)
+  {
+    float const value = i;
+    std::memcpy(body.data() + sizeof(comm::TileHeader) + i * sizeof(float), &value, sizeof(float));
+  }
+
+  return body;
+}
+
+
+SCENARIO(
+  "[Protocol] - Tile bodies must hold exactly the tile's values")
+{
+  GIVEN("A tile header")
+  {
+    comm::TileHeader tile = {};
+    tile.width = 4;
+    tile.height = 3;
+
+    comm::MessageHeader header;
+    header.type = comm::MessageType::TileResult;
+
+    std::vector<float> values;
+
+    WHEN("The body holds one value per pixel")
+    {
+      std::vector<char> const body = genTileBody(tile, 12);
+      header.length = body.size();
+
+      THEN("The values are decoded")
+      {
+        comm::TileHeader const decoded = comm::DecodeTile(header, body, values);
+        REQUIRE(decoded.width == 4);
+        REQUIRE(decoded.height == 3);
+        REQUIRE(values.size() == 12);
+        REQUIRE(values[11] == 11.0f);
+      }
+    }
+
+    WHEN("The body is short or long")
+    {
+      std::vector<char> const short_body = genTileBody(tile, 11);
+      std::vector<char> const long_body = genTileBody(tile, 13);
+
+      THEN("The tile is refused")
+      {
+        REQUIRE_THROWS_AS(comm::DecodeTile(header, short_body, values), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::DecodeTile(header, long_body, values), std::runtime_error);
+      }
+    }
+
+    WHEN("The pixel count wraps round to match the body in 32 bits")
+    {
+      tile.width = 65536;
+      tile.height = 65536;
+      std::vector<char> const empty_body = genTileBody(tile, 0);
+
+      tile.width = 1u << 31;
+      tile.height = 2;
+      std::vector<char> const small_body = genTileBody(tile, 0);
+
+      THEN("The tile is refused")
+      {
+        REQUIRE_THROWS_AS(comm::DecodeTile(header, empty_body, values), std::runtime_error);
+        REQUIRE_THROWS_AS(comm::DecodeTile(header, small_body, values), std::runtime_error);
+      }
+    }
+  }
+}
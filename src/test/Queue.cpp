@@ -6,9 +6,12 @@
 #include "util/Queue.hpp"
 
 // Standard
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <thread>
 #include <algorithm>
+#include <stdexcept>
 #include <stdlib.h>
 #include <time.h>
 
@@ -43,7 +46,7 @@ SCENARIO(
 
       queue.enqueue(enqueue_value);
 
-      float dequeue_value = queue.dequeue();
+      float dequeue_value = *queue.dequeue();
 
       THEN("It's value does not change")
       {
@@ -171,3 +174,335 @@ SCENARIO(
     }
   }
 }
+
+
+SCENARIO(
+  "[Synchronized queue] - Blocked producers and consumers are woken")
+{
+  GIVEN("A single slot queue shared by more threads than it can hold")
+  {
+    unsigned thread_count = 8;
+    unsigned items_per_thread = 4096;
+
+    util::Queue<int> queue(1);
+
+    WHEN("Every thread both enqueues and dequeues through it")
+    {
+      std::vector<long long> sums(thread_count, 0);
+      std::vector<std::thread> enqueue_threads;
+      std::vector<std::thread> dequeue_threads;
+
+      for(unsigned i = 0; i < thread_count; i++)
+      {
+        enqueue_threads.push_back(std::thread([&queue, items_per_thread, i]()
+        {
+          for(unsigned j = 0; j < items_per_thread; j++)
+          {
+            queue.enqueue(i * items_per_thread + j);
+          }
+        }));
+
+        dequeue_threads.push_back(std::thread([&queue, &sums, items_per_thread, i]()
+        {
+          for(unsigned j = 0; j < items_per_thread; j++)
+          {
+            sums[i] += *queue.dequeue();
+          }
+        }));
+      }
+
+      for(unsigned i = 0; i < thread_count; i++)
+      {
+        enqueue_threads[i].join();
+        dequeue_threads[i].join();
+      }
+
+      THEN("Every item comes out exactly once")
+      {
+        long long total = 0;
+        for(long long sum : sums)
+        {
+          total += sum;
+        }
+
+        long long item_count = thread_count * items_per_thread;
+        REQUIRE(total == item_count * (item_count - 1) / 2);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Synchronized queue] - Batched enqueue and dequeue")
+{
+  GIVEN("A queue holding fewer items than were asked for")
+  {
+    util::Queue<int> queue(8);
+
+    queue.enqueue(1);
+    queue.enqueue(2);
+    queue.enqueue(3);
+
+    WHEN("Up to more than that are dequeued")
+    {
+      std::vector<int> output = queue.dequeueUpTo(5);
+
+      THEN("Only what was queued comes out, in order")
+      {
+        REQUIRE(output == std::vector<int>({1, 2, 3}));
+      }
+    }
+
+    WHEN("Up to fewer than that are dequeued")
+    {
+      std::vector<int> output = queue.dequeueUpTo(2);
+
+      THEN("The rest stay queued")
+      {
+        REQUIRE(output == std::vector<int>({1, 2}));
+        REQUIRE(*queue.dequeue() == 3);
+      }
+    }
+  }
+
+  GIVEN("Batches much larger than the queue from several producers")
+  {
+    unsigned thread_count = 4;
+    unsigned items_per_thread = 65536;
+    unsigned batch_length = 100;
+
+    util::Queue<int> queue(32);
+
+    WHEN("Several consumers drain them in batches")
+    {
+      std::vector<long long> sums(thread_count, 0);
+      std::vector<unsigned> counts(thread_count, 0);
+      std::vector<std::thread> enqueue_threads;
+      std::vector<std::thread> dequeue_threads;
+
+      for(unsigned i = 0; i < thread_count; i++)
+      {
+        enqueue_threads.push_back(std::thread([&queue, items_per_thread, batch_length, i]()
+        {
+          std::vector<int> batch;
+
+          for(unsigned j = 0; j < items_per_thread; j++)
+          {
+            batch.push_back(i * items_per_thread + j);
+
+            if(batch.size() == batch_length || j + 1 == items_per_thread)
+            {
+              queue.enqueueVector(batch);
+              batch.clear();
+            }
+          }
+        }));
+      }
+
+      // Consumers stop once they have all drained their share between them
+      std::atomic<unsigned> remaining(thread_count * items_per_thread);
+
+      for(unsigned i = 0; i < thread_count; i++)
+      {
+        dequeue_threads.push_back(std::thread([&queue, &sums, &counts, &remaining, batch_length, i]()
+        {
+          while(1)
+          {
+            unsigned left = remaining.load();
+
+            if(left == 0)
+            {
+              break;
+            }
+
+            unsigned wanted = std::min(left, batch_length);
+
+            if(!remaining.compare_exchange_weak(left, left - wanted))
+            {
+              continue;
+            }
+
+            while(wanted > 0)
+            {
+              std::vector<int> batch = queue.dequeueUpTo(wanted);
+              wanted -= batch.size();
+              counts[i] += batch.size();
+
+              for(int value : batch)
+              {
+                sums[i] += value;
+              }
+            }
+          }
+        }));
+      }
+
+      for(unsigned i = 0; i < thread_count; i++)
+      {
+        enqueue_threads[i].join();
+        dequeue_threads[i].join();
+      }
+
+      THEN("Every item comes out exactly once")
+      {
+        long long total = 0;
+        unsigned count = 0;
+
+        for(unsigned i = 0; i < thread_count; i++)
+        {
+          total += sums[i];
+          count += counts[i];
+        }
+
+        long long item_count = thread_count * items_per_thread;
+        REQUIRE(count == item_count);
+        REQUIRE(total == item_count * (item_count - 1) / 2);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Synchronized queue] - Move-only items")
+{
+  GIVEN("A queue of uniquely owned values")
+  {
+    util::Queue<std::unique_ptr<int>> queue(4);
+
+    WHEN("Items are moved in, emplaced and moved out again")
+    {
+      std::unique_ptr<int> item(new int(1));
+      int * const address = item.get();
+
+      queue.enqueue(std::move(item));
+      queue.emplace(new int(2));
+
+      std::unique_ptr<int> first = *queue.dequeue();
+      std::unique_ptr<int> second = *queue.dequeue();
+
+      THEN("Ownership passes through without copying")
+      {
+        REQUIRE(first.get() == address);
+        REQUIRE(*first == 1);
+        REQUIRE(*second == 2);
+      }
+    }
+
+    WHEN("A batch is moved through")
+    {
+      std::vector<std::unique_ptr<int>> input;
+      for(int i = 0; i < 3; i++)
+      {
+        input.emplace_back(new int(i));
+      }
+
+      queue.enqueueBatch(std::move(input));
+      std::vector<std::unique_ptr<int>> output = queue.dequeueUpTo(3);
+
+      THEN("Every item arrives in order")
+      {
+        REQUIRE(output.size() == 3);
+        REQUIRE(*output[0] == 0);
+        REQUIRE(*output[1] == 1);
+        REQUIRE(*output[2] == 2);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Synchronized queue] - Closing the queue")
+{
+  GIVEN("Consumers blocked on an empty queue")
+  {
+    unsigned thread_count = 8;
+
+    util::Queue<int> queue(4);
+
+    std::vector<int> woken_empty(thread_count, 0);
+    std::vector<std::thread> dequeue_threads;
+
+    for(unsigned i = 0; i < thread_count; i++)
+    {
+      dequeue_threads.push_back(std::thread([&queue, &woken_empty, i]()
+      {
+        woken_empty[i] = !queue.dequeue();
+      }));
+    }
+
+    WHEN("The queue is closed")
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      queue.close();
+
+      for(std::thread & dequeue_thread : dequeue_threads)
+      {
+        dequeue_thread.join();
+      }
+
+      THEN("Every consumer wakes with nothing")
+      {
+        REQUIRE(std::count(woken_empty.begin(), woken_empty.end(), 1) == (int)thread_count);
+      }
+    }
+  }
+
+  GIVEN("Producers blocked on a full queue")
+  {
+    unsigned thread_count = 8;
+
+    util::Queue<int> queue(2);
+    queue.enqueue(1);
+    queue.enqueue(2);
+
+    std::vector<int> refused(thread_count, 0);
+    std::vector<std::thread> enqueue_threads;
+
+    for(unsigned i = 0; i < thread_count; i++)
+    {
+      enqueue_threads.push_back(std::thread([&queue, &refused, i]()
+      {
+        refused[i] = !queue.enqueue(3);
+      }));
+    }
+
+    WHEN("The queue is closed")
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      queue.close();
+
+      for(std::thread & enqueue_thread : enqueue_threads)
+      {
+        enqueue_thread.join();
+      }
+
+      std::vector<int> output(4, 0);
+      size_t dequeued = queue.dequeueVector(output);
+
+      THEN("Every producer is refused and only the earlier items remain")
+      {
+        REQUIRE(std::count(refused.begin(), refused.end(), 1) == (int)thread_count);
+        REQUIRE(dequeued == 2);
+        REQUIRE(output[0] == 1);
+        REQUIRE(output[1] == 2);
+        REQUIRE(queue.dequeueUpTo(4).empty());
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Threaded queue] - Zero capacity is rejected")
+{
+  GIVEN("A capacity of zero")
+  {
+    THEN("Constructing a queue throws")
+    {
+      REQUIRE_THROWS_AS(util::Queue<int>(0), std::invalid_argument);
+    }
+  }
+}
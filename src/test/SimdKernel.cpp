@@ -0,0 +1,116 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/SimpleBrot.hpp"
+#include "compute/Dispatch.hpp"
+
+// Standard
+#include <complex>
+
+
+// Count pixels on which two iteration buffers agree
+template<class T>
+unsigned countMatches(Buffer2D<T>& a, Buffer2D<T>& b)
+{
+  unsigned matches = 0;
+  for(unsigned i = 0; i < a.Height(); i++)
+  {
+    for(unsigned j = 0; j < a.Width(); j++)
+    {
+      matches += (a.Get(j, i) == b.Get(j, i));
+    }
+  }
+  return matches;
+}
+
+
+// Render the default view with an engine and compare it to the scalar path
+template<class T>
+void compareWithScalar(SimpleBrot::Engine const t_engine)
+{
+  unsigned width = 203;
+  unsigned height = 61;
+  unsigned max_iterations = 256;
+  unsigned bailout = 2;
+
+  std::complex<T> start(-2.5, -1.5);
+  std::complex<T> end(1.5, 1.5);
+
+  Buffer2D<unsigned> scalar(width, height);
+  Buffer2D<unsigned> vectorised(width, height);
+
+  SimpleBrot::FillIterationBuffer(scalar, start, end, max_iterations, bailout, SimpleBrot::Engine::Scalar);
+  SimpleBrot::FillIterationBuffer(vectorised, start, end, max_iterations, bailout, t_engine);
+
+  REQUIRE(countMatches(scalar, vectorised) == width * height);
+}
+
+
+SCENARIO(
+  "[SIMD kernel] - Vectorised engines agree with the scalar engine")
+{
+  GIVEN("Each engine supported by this CPU")
+  {
+    for(SimpleBrot::Engine const engine : SimpleBrot::AllEngines())
+    {
+      if(!SimpleBrot::EngineSupported(engine))
+      {
+        continue;
+      }
+
+      WHEN("The " + SimpleBrot::EngineName(engine) + " engine fills a float buffer")
+      {
+        THEN("It matches the scalar kernel")
+        {
+          compareWithScalar<float>(engine);
+        }
+      }
+
+      WHEN("The " + SimpleBrot::EngineName(engine) + " engine fills a double buffer")
+      {
+        THEN("It matches the scalar kernel")
+        {
+          compareWithScalar<double>(engine);
+        }
+      }
+
+      WHEN("The " + SimpleBrot::EngineName(engine) + " engine fills a double-double buffer")
+      {
+        THEN("It matches the scalar kernel")
+        {
+          compareWithScalar<SimpleBrot::DoubleDouble>(engine);
+        }
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[SIMD kernel] - Engine selection")
+{
+  GIVEN("The engine option value \"auto\"")
+  {
+    THEN("The detected engine is selected and is supported")
+    {
+      SimpleBrot::Engine engine = SimpleBrot::SelectEngine("auto");
+      REQUIRE(engine == SimpleBrot::DetectEngine());
+      REQUIRE(SimpleBrot::EngineSupported(engine) == true);
+    }
+  }
+
+  GIVEN("An explicit engine name")
+  {
+    THEN("The scalar engine can always be selected")
+    {
+      REQUIRE(SimpleBrot::SelectEngine("scalar") == SimpleBrot::Engine::Scalar);
+    }
+
+    THEN("Unknown names are rejected")
+    {
+      REQUIRE_THROWS(SimpleBrot::SelectEngine("neon"));
+    }
+  }
+}
@@ -0,0 +1,272 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/SimpleBrot.hpp"
+#include "compute/Dispatch.hpp"
+
+// Standard
+#include <complex>
+
+
+SCENARIO(
+  "[SimpleBrot] - Main cardioid and period 2 bulb short circuit")
+{
+  GIVEN("Points known to be inside and outside the cardioid and bulb")
+  {
+    THEN("Interior points are recognised")
+    {
+      REQUIRE(SimpleBrot::InMainCardioidOrBulb(std::complex<double>(0, 0)) == true);
+      REQUIRE(SimpleBrot::InMainCardioidOrBulb(std::complex<double>(-1, 0)) == true);
+      REQUIRE(SimpleBrot::InMainCardioidOrBulb(std::complex<double>(0.2, 0.4)) == true);
+    }
+
+    THEN("Exterior and other interior points are not")
+    {
+      REQUIRE(SimpleBrot::InMainCardioidOrBulb(std::complex<double>(0.3, 0)) == false);
+      REQUIRE(SimpleBrot::InMainCardioidOrBulb(std::complex<double>(-1.3, 0)) == false);
+      REQUIRE(SimpleBrot::InMainCardioidOrBulb(std::complex<double>(-0.12, 0.75)) == false);
+    }
+  }
+
+  GIVEN("The default client view")
+  {
+    unsigned width = 160;
+    unsigned height = 120;
+    unsigned max_iterations = 64;
+    unsigned bailout = 2;
+
+    std::complex<float> start(-2.5, -1.5);
+    std::complex<float> end(1.5, 1.5);
+
+    WHEN("It is rendered by each supported engine")
+    {
+      SimpleBrot::KernelStats scalar_stats;
+      Buffer2D<unsigned> scalar(width, height);
+      SimpleBrot::FillIterationBuffer(
+        scalar, start, end, max_iterations, bailout, SimpleBrot::Engine::Scalar, &scalar_stats);
+
+      THEN("A large share of pixels is short circuited, identically by every engine")
+      {
+        REQUIRE(scalar_stats.iteratedPixels == width * height);
+        REQUIRE(scalar_stats.interiorShortCircuits > (width * height) / 10);
+
+        for(SimpleBrot::Engine const engine : SimpleBrot::AllEngines())
+        {
+          if(SimpleBrot::EngineSupported(engine))
+          {
+            SimpleBrot::KernelStats stats;
+            Buffer2D<unsigned> buffer(width, height);
+            SimpleBrot::FillIterationBuffer(
+              buffer, start, end, max_iterations, bailout, engine, &stats);
+
+            REQUIRE(stats.iteratedPixels == scalar_stats.iteratedPixels);
+            REQUIRE(stats.interiorShortCircuits == scalar_stats.interiorShortCircuits);
+          }
+        }
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[SimpleBrot] - Periodicity detection")
+{
+  GIVEN("A view centred on the period 3 bulb with a high iteration limit")
+  {
+    unsigned width = 64;
+    unsigned height = 64;
+    unsigned max_iterations = 20000;
+    unsigned bailout = 2;
+
+    std::complex<double> start(-0.25, 0.6);
+    std::complex<double> end(0.05, 0.9);
+
+    WHEN("It is rendered with and without periodicity checking")
+    {
+      SimpleBrot::KernelStats stats;
+      Buffer2D<unsigned> checked(width, height);
+      SimpleBrot::FillIterationBuffer(
+        checked, start, end, max_iterations, bailout, SimpleBrot::Engine::Scalar, &stats);
+
+      Buffer2D<unsigned> unchecked(width, height);
+      double r_step = (end.real() - start.real()) / width;
+      double i_step = (end.imag() - start.imag()) / height;
+      for(unsigned i = 0; i < height; i++)
+      {
+        SimpleBrot::FillIterationRow(
+          &unchecked.Get(0, i), width, start.real(), r_step, start.imag() + (i_step * i),
+          max_iterations, bailout, 0.0);
+      }
+
+      THEN("Interior orbits exit early without changing the image")
+      {
+        REQUIRE(stats.periodicExits > (width * height) / 4);
+
+        unsigned matches = 0;
+        for(unsigned i = 0; i < height; i++)
+        {
+          for(unsigned j = 0; j < width; j++)
+          {
+            matches += (checked.Get(j, i) == unchecked.Get(j, i));
+          }
+        }
+        REQUIRE(matches == width * height);
+      }
+
+      THEN("Every engine catches the same cycles")
+      {
+        for(SimpleBrot::Engine const engine : SimpleBrot::AllEngines())
+        {
+          if(SimpleBrot::EngineSupported(engine))
+          {
+            SimpleBrot::KernelStats engine_stats;
+            Buffer2D<unsigned> buffer(width, height);
+            SimpleBrot::FillIterationBuffer(
+              buffer, start, end, max_iterations, bailout, engine, &engine_stats);
+
+            REQUIRE(engine_stats.periodicExits == stats.periodicExits);
+          }
+        }
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[SimpleBrot] - Smooth iteration counts")
+{
+  GIVEN("The default client view")
+  {
+    unsigned width = 131;
+    unsigned height = 67;
+    unsigned max_iterations = 128;
+    unsigned bailout = 4;
+
+    std::complex<double> start(-2.5, -1.5);
+    std::complex<double> end(1.5, 1.5);
+
+    Buffer2D<unsigned> counts(width, height);
+    Buffer2D<float> smooth(width, height);
+    SimpleBrot::FillIterationBuffer(counts, start, end, max_iterations, bailout);
+    SimpleBrot::FillSmoothIterationBuffer(smooth, start, end, max_iterations, bailout);
+
+    THEN("Each smooth count lies within one of its integer count")
+    {
+      for(unsigned i = 0; i < height; i++)
+      {
+        for(unsigned j = 0; j < width; j++)
+        {
+          float const s = smooth.Get(j, i);
+          unsigned const n = counts.Get(j, i);
+          if(n == max_iterations)
+          {
+            REQUIRE(s == float(max_iterations));
+          }
+          else
+          {
+            REQUIRE(s >= float(n));
+            REQUIRE(s <= float(n + 1));
+          }
+        }
+      }
+    }
+
+    THEN("Every engine produces the same smooth counts")
+    {
+      for(SimpleBrot::Engine const engine : SimpleBrot::AllEngines())
+      {
+        if(SimpleBrot::EngineSupported(engine))
+        {
+          Buffer2D<float> vectorised(width, height);
+          SimpleBrot::FillSmoothIterationBuffer(vectorised, start, end, max_iterations, bailout, engine);
+
+          unsigned matches = 0;
+          for(unsigned i = 0; i < height; i++)
+          {
+            for(unsigned j = 0; j < width; j++)
+            {
+              matches += (vectorised.Get(j, i) == smooth.Get(j, i));
+            }
+          }
+          REQUIRE(matches == width * height);
+        }
+      }
+    }
+  }
+
+  GIVEN("Two points escaping on the same iteration")
+  {
+    unsigned max_iterations = 64;
+    unsigned bailout = 2;
+
+    // Both escape on the same iteration, the nearer to the set escapes later
+    std::complex<double> outer(0.5, 0.5);
+    std::complex<double> inner(0.48, 0.5);
+
+    THEN("The point nearer the set has the larger smooth count")
+    {
+      REQUIRE(SimpleBrot::ComputeIterationCount(outer, max_iterations, bailout) ==
+              SimpleBrot::ComputeIterationCount(inner, max_iterations, bailout));
+      REQUIRE(SimpleBrot::ComputeSmoothIterationCount(inner, max_iterations, bailout) >
+              SimpleBrot::ComputeSmoothIterationCount(outer, max_iterations, bailout));
+    }
+  }
+}
+
+
+SCENARIO(
+  "[SimpleBrot] - Streaming supersample reduction")
+{
+  GIVEN("A view supersampled 3 times in each direction")
+  {
+    unsigned width = 53;
+    unsigned height = 31;
+    unsigned scale = 3;
+    unsigned max_iterations = 64;
+    unsigned bailout = 2;
+
+    std::complex<double> start(-2.5, -1.5);
+    std::complex<double> end(1.5, 1.5);
+
+    // The full size buffers the streaming path replaces
+    Buffer2D<unsigned> fullCounts(width * scale, height * scale);
+    Buffer2D<float> fullSmooth(width * scale, height * scale);
+    SimpleBrot::FillIterationBuffer(fullCounts, start, end, max_iterations, bailout);
+    SimpleBrot::FillSmoothIterationBuffer(fullSmooth, start, end, max_iterations, bailout);
+
+    Buffer2D<unsigned> counts(width, height);
+    Buffer2D<float> smooth(width, height);
+    SimpleBrot::ComputeIterations(counts, start, end, max_iterations, bailout, scale);
+    SimpleBrot::ComputeSmoothIterations(smooth, start, end, max_iterations, bailout, scale);
+
+    THEN("Each pixel is the mean of its supersamples in the full buffer")
+    {
+      bool counts_match = true;
+      bool smooth_match = true;
+      for(unsigned i = 0; i < height; i++)
+      {
+        for(unsigned j = 0; j < width; j++)
+        {
+          float countSum = 0;
+          float smoothSum = 0;
+          for(unsigned k = 0; k < scale; k++)
+          {
+            for(unsigned l = 0; l < scale; l++)
+            {
+              countSum += fullCounts.Get(j * scale + l, i * scale + k);
+              smoothSum += fullSmooth.Get(j * scale + l, i * scale + k);
+            }
+          }
+          counts_match = counts_match && (counts.Get(j, i) == unsigned(countSum / (scale * scale)));
+          smooth_match = smooth_match && (smooth.Get(j, i) == smoothSum / (scale * scale));
+        }
+      }
+      REQUIRE(counts_match == true);
+      REQUIRE(smooth_match == true);
+    }
+  }
+}
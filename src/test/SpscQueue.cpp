@@ -0,0 +1,299 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "util/SpscQueue.hpp"
+#include "util/Worker.hpp"
+
+// Standard
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+SCENARIO(
+  "[SPSC queue] - Serial read write test")
+{
+  GIVEN("A vector several times longer than the queue")
+  {
+    unsigned queue_length = 7;
+    unsigned test_vector_length = 100;
+
+    std::vector<int> input_vector(test_vector_length);
+    std::iota(input_vector.begin(), input_vector.end(), 0);
+
+    util::SpscQueue<int> queue(queue_length);
+
+    WHEN("It is pushed through the queue a few values at a time")
+    {
+      std::vector<int> output_vector;
+
+      for(unsigned i = 0; i < input_vector.size(); i += queue_length)
+      {
+        unsigned end = std::min<unsigned>(i + queue_length, input_vector.size());
+
+        for(unsigned j = i; j < end; j++)
+        {
+          queue.enqueue(input_vector[j]);
+        }
+
+        for(unsigned j = i; j < end; j++)
+        {
+          output_vector.push_back(*queue.dequeue());
+        }
+      }
+
+      THEN("Values come out in order as the indices wrap around the ring")
+      {
+        REQUIRE(output_vector == input_vector);
+      }
+    }
+  }
+
+  GIVEN("A closed queue with an item left in it")
+  {
+    util::SpscQueue<int> queue(2);
+
+    queue.enqueue(42);
+    queue.close();
+
+    WHEN("It is used again")
+    {
+      bool enqueued = queue.enqueue(7);
+      boost::optional<int> first = queue.dequeue();
+      boost::optional<int> second = queue.dequeue();
+
+      THEN("Nothing more goes in, and it drains then gives nothing")
+      {
+        REQUIRE(enqueued == false);
+        REQUIRE(first.is_initialized() == true);
+        REQUIRE(*first == 42);
+        REQUIRE(second.is_initialized() == false);
+      }
+    }
+  }
+
+  GIVEN("A consumer blocked on an empty queue")
+  {
+    util::SpscQueue<int> queue(2);
+
+    boost::optional<int> data(0);
+    std::thread dequeue_thread([&queue, &data]()
+    {
+      data = queue.dequeue();
+    });
+
+    WHEN("The queue is closed")
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      queue.close();
+      dequeue_thread.join();
+
+      THEN("The consumer wakes with nothing")
+      {
+        REQUIRE(data.is_initialized() == false);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[SPSC queue] - Asynchronous read-write test")
+{
+  GIVEN("An arbitrary vector of variables")
+  {
+    unsigned test_vector_length = 262144;
+
+    std::vector<int> input_vector(test_vector_length);
+    std::iota(input_vector.begin(), input_vector.end(), 0);
+    std::vector<int> output_vector(test_vector_length);
+
+    WHEN("It is queued and dequeued concurrently through a single slot queue")
+    {
+      util::SpscQueue<int> queue(1);
+
+      std::thread enqueue_thread(&util::SpscQueue<int>::enqueueVector, &queue, std::ref(input_vector));
+      std::thread dequeue_thread(&util::SpscQueue<int>::dequeueVector, &queue, std::ref(output_vector));
+
+      enqueue_thread.join();
+      dequeue_thread.join();
+
+      THEN("Vector values are correctly preserved")
+      {
+        REQUIRE(output_vector == input_vector);
+      }
+    }
+
+    WHEN("It is queued and dequeued concurrently through a longer queue")
+    {
+      util::SpscQueue<int> queue(32);
+
+      std::thread enqueue_thread(&util::SpscQueue<int>::enqueueVector, &queue, std::ref(input_vector));
+      std::thread dequeue_thread(&util::SpscQueue<int>::dequeueVector, &queue, std::ref(output_vector));
+
+      enqueue_thread.join();
+      dequeue_thread.join();
+
+      THEN("Vector values are correctly preserved")
+      {
+        REQUIRE(output_vector == input_vector);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[SPSC queue] - Batched enqueue and dequeue")
+{
+  GIVEN("Batches larger than the queue")
+  {
+    unsigned test_vector_length = 262144;
+    unsigned batch_length = 100;
+
+    std::vector<int> input_vector(test_vector_length);
+    std::iota(input_vector.begin(), input_vector.end(), 0);
+
+    util::SpscQueue<int> queue(32);
+
+    WHEN("They are enqueued whole and drained a few at a time")
+    {
+      std::thread enqueue_thread([&queue, &input_vector, batch_length]()
+      {
+        for(unsigned i = 0; i < input_vector.size(); i += batch_length)
+        {
+          unsigned end = std::min<unsigned>(i + batch_length, input_vector.size());
+          queue.enqueueVector(std::vector<int>(input_vector.begin() + i, input_vector.begin() + end));
+        }
+      });
+
+      std::vector<int> output_vector;
+
+      while(output_vector.size() < test_vector_length)
+      {
+        std::vector<int> batch = queue.dequeueUpTo(std::min<unsigned>(batch_length, test_vector_length - output_vector.size()));
+        output_vector.insert(output_vector.end(), batch.begin(), batch.end());
+      }
+
+      enqueue_thread.join();
+
+      THEN("Values come out in order")
+      {
+        REQUIRE(output_vector == input_vector);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[SPSC queue] - Move-only items")
+{
+  GIVEN("A queue of uniquely owned values")
+  {
+    util::SpscQueue<std::unique_ptr<int>> queue(2);
+
+    WHEN("Items are moved in, emplaced and moved out again")
+    {
+      std::unique_ptr<int> item(new int(1));
+      int * const address = item.get();
+
+      queue.enqueue(std::move(item));
+      queue.emplace(new int(2));
+
+      std::unique_ptr<int> first = *queue.dequeue();
+      std::unique_ptr<int> second = *queue.dequeue();
+
+      THEN("Ownership passes through without copying")
+      {
+        REQUIRE(first.get() == address);
+        REQUIRE(*first == 1);
+        REQUIRE(*second == 2);
+      }
+    }
+  }
+}
+
+
+class DoublingWorker : public util::Worker<int>
+{
+private:
+  std::shared_ptr<util::BoundedQueue<int>> m_output_queue;
+
+  void processWorkItem(int t_data)
+  {
+    m_output_queue->enqueue(2 * t_data);
+  }
+
+public:
+  DoublingWorker(
+    std::shared_ptr<util::BoundedQueue<int>> t_input_queue,
+    std::shared_ptr<util::BoundedQueue<int>> t_output_queue) :
+    util::Worker<int>(t_input_queue, 1),
+    m_output_queue(t_output_queue)
+  {}
+
+  ~DoublingWorker()
+  {
+    this->stop();
+  }
+};
+
+
+SCENARIO(
+  "[SPSC queue] - Single threaded worker between SPSC queues")
+{
+  GIVEN("A worker with one thread reading and writing SPSC queues")
+  {
+    unsigned test_vector_length = 4096;
+
+    std::vector<int> input_vector(test_vector_length);
+    std::iota(input_vector.begin(), input_vector.end(), 0);
+    std::vector<int> output_vector(test_vector_length);
+
+    std::shared_ptr<util::SpscQueue<int>> input_queue(new util::SpscQueue<int>(16));
+    std::shared_ptr<util::SpscQueue<int>> output_queue(new util::SpscQueue<int>(16));
+
+    WHEN("A vector is passed through it")
+    {
+      {
+        DoublingWorker worker(input_queue, output_queue);
+
+        std::thread enqueue_thread(&util::SpscQueue<int>::enqueueVector, &(*input_queue), std::ref(input_vector));
+        output_queue->dequeueVector(output_vector);
+        enqueue_thread.join();
+      }
+
+      THEN("Every value is processed in order")
+      {
+        bool doubled = true;
+
+        for(unsigned i = 0; i < test_vector_length; i++)
+        {
+          doubled = doubled && (output_vector[i] == 2 * input_vector[i]);
+        }
+
+        REQUIRE(doubled == true);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[SPSC queue] - Zero capacity is rejected")
+{
+  GIVEN("A capacity of zero")
+  {
+    THEN("Constructing a queue throws")
+    {
+      REQUIRE_THROWS_AS(util::SpscQueue<int>(0), std::invalid_argument);
+    }
+  }
+}
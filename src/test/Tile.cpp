@@ -0,0 +1,328 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/Dispatch.hpp"
+#include "compute/Tile.hpp"
+
+// Standard
+#include <cmath>
+#include <complex>
+#include <vector>
+
+
+SCENARIO(
+  "[Tile] - Splitting a frame covers every pixel once")
+{
+  GIVEN("A frame that does not divide evenly into tiles")
+  {
+    SimpleBrot::Tile frame = SimpleBrot::FrameTile(
+      std::complex<SimpleBrot::QuadDouble>(-2.5, -1.5), std::complex<SimpleBrot::QuadDouble>(1.5, 1.5), 100, 70, 64, 2);
+
+    std::vector<SimpleBrot::Tile> tiles = SimpleBrot::SplitFrame(frame, 32, 16);
+
+    THEN("Each pixel belongs to exactly one tile")
+    {
+      REQUIRE(tiles.size() == 4 * 5);
+
+      std::vector<unsigned> covered(frame.width * frame.height, 0);
+      for(SimpleBrot::Tile const& tile : tiles)
+      {
+        REQUIRE(tile.width <= 32);
+        REQUIRE(tile.height <= 16);
+        for(unsigned i = tile.y; i < tile.y + tile.height; i++)
+        {
+          for(unsigned j = tile.x; j < tile.x + tile.width; j++)
+          {
+            covered[i * frame.width + j]++;
+          }
+        }
+      }
+
+      for(unsigned count : covered)
+      {
+        REQUIRE(count == 1);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Tile] - Stitched tiles match a whole frame render")
+{
+  GIVEN("The default client view rendered whole and in tiles")
+  {
+    SimpleBrot::Tile frame = SimpleBrot::FrameTile(
+      std::complex<SimpleBrot::QuadDouble>(-2.5, -1.5), std::complex<SimpleBrot::QuadDouble>(1.5, 1.5), 120, 90, 64, 2);
+
+    THEN("Single precision is enough for the view")
+    {
+      REQUIRE(frame.precision == SimpleBrot::Precision::Float);
+    }
+
+    THEN("Every pixel is identical at single and double precision")
+    {
+      for(SimpleBrot::Precision const precision : {SimpleBrot::Precision::Float, SimpleBrot::Precision::Double})
+      {
+        frame.precision = precision;
+
+        Buffer2D<float> whole;
+        SimpleBrot::RenderTile(frame, whole);
+
+        // Tiles go through the vectorised kernels where the CPU has them
+        Buffer2D<float> stitched(frame.width, frame.height);
+        for(SimpleBrot::Tile const& tile : SimpleBrot::SplitFrame(frame, 32, 32))
+        {
+          Buffer2D<float> data;
+          SimpleBrot::RenderTile(tile, data, SimpleBrot::DetectEngine());
+          REQUIRE(data.Width() == tile.width);
+          REQUIRE(data.Height() == tile.height);
+          SimpleBrot::CopyTileToFrame(tile, data, stitched);
+        }
+
+        unsigned mismatches = 0;
+        for(unsigned i = 0; i < frame.height; i++)
+        {
+          for(unsigned j = 0; j < frame.width; j++)
+          {
+            mismatches += (whole.Get(j, i) != stitched.Get(j, i));
+          }
+        }
+        REQUIRE(mismatches == 0);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Tile] - Supersampled tiles refine the same edges as a whole frame")
+{
+  GIVEN("A supersampled frame rendered whole and in tiles")
+  {
+    SimpleBrot::Tile frame = SimpleBrot::FrameTile(
+      std::complex<SimpleBrot::QuadDouble>(-2.5, -1.5), std::complex<SimpleBrot::QuadDouble>(1.5, 1.5), 120, 90, 64, 2, 3);
+    frame.precision = SimpleBrot::Precision::Double;
+
+    SimpleBrot::KernelStats whole_stats;
+    Buffer2D<float> whole;
+    SimpleBrot::RenderTile(frame, whole, SimpleBrot::Engine::Scalar, &whole_stats);
+
+    SimpleBrot::KernelStats tile_stats;
+    Buffer2D<float> stitched(frame.width, frame.height);
+    for(SimpleBrot::Tile const& tile : SimpleBrot::SplitFrame(frame, 32, 32))
+    {
+      Buffer2D<float> data;
+      SimpleBrot::RenderTile(tile, data, SimpleBrot::Engine::Scalar, &tile_stats);
+      SimpleBrot::CopyTileToFrame(tile, data, stitched);
+    }
+
+    THEN("Pixels on tile borders are classified as in the whole frame")
+    {
+      REQUIRE(whole_stats.extraSamples > 0);
+      REQUIRE(tile_stats.extraSamples == whole_stats.extraSamples);
+    }
+
+    THEN("Every pixel is identical")
+    {
+      unsigned mismatches = 0;
+      for(unsigned i = 0; i < frame.height; i++)
+      {
+        for(unsigned j = 0; j < frame.width; j++)
+        {
+          mismatches += (whole.Get(j, i) != stitched.Get(j, i));
+        }
+      }
+      REQUIRE(mismatches == 0);
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Tile] - Double-double frames iterate directly with the selected engine")
+{
+  GIVEN("A frame past double precision around a boundary point")
+  {
+    SimpleBrot::QuadDouble center_re(-0.7436438870371587);
+    SimpleBrot::QuadDouble center_im(0.1318259042053120);
+    SimpleBrot::QuadDouble half_re(4e-12);
+    SimpleBrot::QuadDouble half_im(3e-12);
+
+    SimpleBrot::Tile frame = SimpleBrot::FrameTile(
+      std::complex<SimpleBrot::QuadDouble>(center_re - half_re, center_im - half_im),
+      std::complex<SimpleBrot::QuadDouble>(center_re + half_re, center_im + half_im), 48, 36, 1024, 2);
+
+    THEN("Double-double precision is selected")
+    {
+      REQUIRE(frame.precision == SimpleBrot::Precision::DoubleDouble);
+    }
+
+    WHEN("It is rendered as a tile and by direct double-double iteration")
+    {
+      Buffer2D<float> tiled;
+      SimpleBrot::RenderTile(frame, tiled);
+
+      Buffer2D<float> direct(frame.width, frame.height);
+      SimpleBrot::FillSmoothIterationBuffer(
+        direct,
+        std::complex<SimpleBrot::DoubleDouble>(
+          SimpleBrot::NarrowTo<SimpleBrot::DoubleDouble>(frame.start.real()),
+          SimpleBrot::NarrowTo<SimpleBrot::DoubleDouble>(frame.start.imag())),
+        std::complex<SimpleBrot::DoubleDouble>(
+          SimpleBrot::NarrowTo<SimpleBrot::DoubleDouble>(frame.end.real()),
+          SimpleBrot::NarrowTo<SimpleBrot::DoubleDouble>(frame.end.imag())),
+        frame.maxIterations, frame.bailout);
+
+      THEN("Every pixel is identical")
+      {
+        unsigned mismatches = 0;
+        for(unsigned i = 0; i < frame.height; i++)
+        {
+          for(unsigned j = 0; j < frame.width; j++)
+          {
+            mismatches += (direct.Get(j, i) != tiled.Get(j, i));
+          }
+        }
+        REQUIRE(mismatches == 0);
+      }
+    }
+
+    WHEN("Its tiles are rendered by every supported engine")
+    {
+      Buffer2D<float> whole;
+      SimpleBrot::RenderTile(frame, whole);
+
+      THEN("Each engine stitches the scalar frame exactly")
+      {
+        for(SimpleBrot::Engine const engine : SimpleBrot::AllEngines())
+        {
+          if(!SimpleBrot::EngineSupported(engine))
+          {
+            continue;
+          }
+
+          Buffer2D<float> stitched(frame.width, frame.height);
+          for(SimpleBrot::Tile const& tile : SimpleBrot::SplitFrame(frame, 24, 16))
+          {
+            Buffer2D<float> data;
+            SimpleBrot::RenderTile(tile, data, engine);
+            SimpleBrot::CopyTileToFrame(tile, data, stitched);
+          }
+
+          unsigned mismatches = 0;
+          for(unsigned i = 0; i < frame.height; i++)
+          {
+            for(unsigned j = 0; j < frame.width; j++)
+            {
+              mismatches += (whole.Get(j, i) != stitched.Get(j, i));
+            }
+          }
+          REQUIRE(mismatches == 0);
+        }
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Tile] - Frames past double-double precision render by perturbation")
+{
+  GIVEN("A deep frame around a boundary point")
+  {
+    SimpleBrot::QuadDouble center_re(-0.7436438870371587);
+    SimpleBrot::QuadDouble center_im(0.1318259042053120);
+    SimpleBrot::QuadDouble half_re(4e-30);
+    SimpleBrot::QuadDouble half_im(3e-30);
+
+    SimpleBrot::Tile frame = SimpleBrot::FrameTile(
+      std::complex<SimpleBrot::QuadDouble>(center_re - half_re, center_im - half_im),
+      std::complex<SimpleBrot::QuadDouble>(center_re + half_re, center_im + half_im), 48, 36, 1024, 2);
+
+    THEN("Quad-double precision is selected")
+    {
+      REQUIRE(frame.precision == SimpleBrot::Precision::QuadDouble);
+    }
+
+    WHEN("It is rendered as a tile and by direct quad-double iteration")
+    {
+      Buffer2D<float> perturbed;
+      SimpleBrot::RenderTile(frame, perturbed);
+
+      Buffer2D<float> direct(frame.width, frame.height);
+      SimpleBrot::FillSmoothIterationBuffer(direct, frame.start, frame.end, frame.maxIterations, frame.bailout);
+
+      THEN("Nearly all pixels agree")
+      {
+        unsigned matches = 0;
+        for(unsigned i = 0; i < frame.height; i++)
+        {
+          for(unsigned j = 0; j < frame.width; j++)
+          {
+            matches += (std::fabs(direct.Get(j, i) - perturbed.Get(j, i)) < 1e-2f);
+          }
+        }
+
+        // Chaotic pixels on the boundary amplify last bit differences
+        REQUIRE(matches >= (frame.width * frame.height * 99) / 100);
+      }
+    }
+
+    WHEN("It is rendered whole and in tiles")
+    {
+      Buffer2D<float> whole;
+      SimpleBrot::RenderTile(frame, whole);
+
+      Buffer2D<float> stitched(frame.width, frame.height);
+      for(SimpleBrot::Tile const& tile : SimpleBrot::SplitFrame(frame, 24, 16))
+      {
+        Buffer2D<float> data;
+        SimpleBrot::RenderTile(tile, data);
+        SimpleBrot::CopyTileToFrame(tile, data, stitched);
+      }
+
+      THEN("Every pixel is identical")
+      {
+        for(unsigned i = 0; i < frame.height; i++)
+        {
+          for(unsigned j = 0; j < frame.width; j++)
+          {
+            REQUIRE(whole.Get(j, i) == stitched.Get(j, i));
+          }
+        }
+      }
+    }
+
+    WHEN("Its tiles share one reference built for the frame")
+    {
+      Buffer2D<float> whole;
+      SimpleBrot::RenderTile(frame, whole);
+
+      SimpleBrot::FrameReference const reference(frame);
+
+      Buffer2D<float> stitched(frame.width, frame.height);
+      for(SimpleBrot::Tile const& tile : SimpleBrot::SplitFrame(frame, 24, 16))
+      {
+        Buffer2D<float> data;
+        SimpleBrot::RenderTile(tile, data, SimpleBrot::Engine::Scalar, nullptr, &reference);
+        SimpleBrot::CopyTileToFrame(tile, data, stitched);
+      }
+
+      THEN("Every pixel is identical to building it per tile")
+      {
+        unsigned mismatches = 0;
+        for(unsigned i = 0; i < frame.height; i++)
+        {
+          for(unsigned j = 0; j < frame.width; j++)
+          {
+            mismatches += (whole.Get(j, i) != stitched.Get(j, i));
+          }
+        }
+        REQUIRE(mismatches == 0);
+      }
+    }
+  }
+}
@@ -53,6 +53,11 @@ public:
     Worker(t_input_queue, t_thread_count),
     m_ackermann_result_queue(t_ackermann_result_queue)
   {}
+
+  ~AckermannWorker()
+  {
+    this->stop();
+  }
 };
 
 
@@ -121,3 +126,121 @@ SCENARIO(
     }
   }
 }
+
+
+// Test worker, takes ownership of each input and hands it straight on
+class ForwardingWorker : public util::Worker<std::unique_ptr<unsigned>>
+{
+private:
+  std::shared_ptr<util::Queue<std::unique_ptr<unsigned>>> m_output_queue;
+
+  virtual void processWorkItem(std::unique_ptr<unsigned> t_input)
+  {
+    *t_input += 1;
+    this->m_output_queue->enqueue(std::move(t_input));
+  }
+
+public:
+  ForwardingWorker(
+    std::shared_ptr<util::Queue<std::unique_ptr<unsigned>>> t_input_queue,
+    std::shared_ptr<util::Queue<std::unique_ptr<unsigned>>> t_output_queue,
+    unsigned const t_thread_count) :
+    Worker(t_input_queue, t_thread_count),
+    m_output_queue(t_output_queue)
+  {}
+
+  ~ForwardingWorker()
+  {
+    this->stop();
+  }
+};
+
+
+SCENARIO(
+  "[Worker] - Move-only work items")
+{
+  GIVEN("A set of uniquely owned inputs")
+  {
+    unsigned input_count = 1024;
+
+    std::shared_ptr<util::Queue<std::unique_ptr<unsigned>>> input_queue(new util::Queue<std::unique_ptr<unsigned>>(4));
+    std::shared_ptr<util::Queue<std::unique_ptr<unsigned>>> output_queue(new util::Queue<std::unique_ptr<unsigned>>(4));
+
+    WHEN("They are processed by a work queue")
+    {
+      std::vector<unsigned*> addresses;
+      std::vector<unsigned*> output_addresses;
+      unsigned long total = 0;
+
+      {
+        ForwardingWorker worker(input_queue, output_queue, 4);
+
+        std::thread enqueue_thread([&input_queue, &addresses, input_count]()
+        {
+          for(unsigned i = 0; i < input_count; i++)
+          {
+            std::unique_ptr<unsigned> input(new unsigned(i));
+            addresses.push_back(input.get());
+            input_queue->enqueue(std::move(input));
+          }
+        });
+
+        std::vector<std::unique_ptr<unsigned>> outputs;
+
+        for(unsigned i = 0; i < input_count; i++)
+        {
+          outputs.push_back(*output_queue->dequeue());
+          output_addresses.push_back(outputs.back().get());
+          total += *outputs.back();
+        }
+
+        enqueue_thread.join();
+      }
+
+      THEN("Every item is moved through rather than copied")
+      {
+        std::sort(addresses.begin(), addresses.end());
+        std::sort(output_addresses.begin(), output_addresses.end());
+
+        REQUIRE(output_addresses == addresses);
+        REQUIRE(total == (unsigned long)input_count * (input_count + 1) / 2);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "[Worker] - Queued items are processed on destruction")
+{
+  GIVEN("A worker with a backlog of inputs")
+  {
+    unsigned input_count = 64;
+
+    std::shared_ptr<util::Queue<std::unique_ptr<unsigned>>> input_queue(new util::Queue<std::unique_ptr<unsigned>>(input_count));
+    std::shared_ptr<util::Queue<std::unique_ptr<unsigned>>> output_queue(new util::Queue<std::unique_ptr<unsigned>>(input_count));
+
+    WHEN("The worker is destroyed straight away")
+    {
+      {
+        ForwardingWorker worker(input_queue, output_queue, 1);
+
+        for(unsigned i = 0; i < input_count; i++)
+        {
+          input_queue->enqueue(std::unique_ptr<unsigned>(new unsigned(i)));
+        }
+      }
+
+      THEN("Every input still reaches the output")
+      {
+        unsigned long total = 0;
+        for(unsigned i = 0; i < input_count; i++)
+        {
+          total += **output_queue->dequeue();
+        }
+
+        REQUIRE(total == (unsigned long)input_count * (input_count + 1) / 2);
+      }
+    }
+  }
+}
@@ -106,6 +106,11 @@ public:
     Worker(t_input_queue, t_thread_count),
     m_ackermann_result_queue(t_ackermann_result_queue)
   {}
+
+  ~AckermannWorker()
+  {
+    this->stop();
+  }
 };
 
 
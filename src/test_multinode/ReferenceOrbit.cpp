@@ -0,0 +1,112 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/ReferenceBroadcaster.hpp"
+#include "compute/ReferenceCache.hpp"
+#include "compute/ReferenceOrbit.hpp"
+#include "compute/Tile.hpp"
+#include "mpi/comm.hpp"
+
+// External
+#include "mpi.h"
+
+// Standard
+#include <complex>
+#include <memory>
+
+
+SCENARIO(
+  "Reference orbit broadcast test")
+{
+  int head_rank = 0;
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  GIVEN("A reference orbit computed on the head rank only")
+  {
+    SimpleBrot::ReferenceOrbit orbit;
+
+    if(mpi::comm::rank(communicator) == head_rank)
+    {
+      orbit.Compute("-0.743643887037151", "0.131825904205330", 1e-12, 4096, 2);
+    }
+
+    WHEN("It is broadcast from the head rank")
+    {
+      orbit.mpiBroadcast(head_rank, communicator);
+
+      THEN("Every rank holds the same orbit as a local computation")
+      {
+        SimpleBrot::ReferenceOrbit expected;
+        expected.Compute("-0.743643887037151", "0.131825904205330", 1e-12, 4096, 2);
+
+        REQUIRE(orbit.Length() == expected.Length());
+
+        bool orbits_match = true;
+        for(unsigned i = 0; i < orbit.Length(); i++)
+        {
+          orbits_match = orbits_match && (orbit.Get(i) == expected.Get(i));
+        }
+        REQUIRE(orbits_match == true);
+      }
+    }
+  }
+}
+
+
+SCENARIO(
+  "Frame reference broadcaster test")
+{
+  int head_rank = 0;
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  GIVEN("A deep frame")
+  {
+    SimpleBrot::QuadDouble center_re(-0.7436438870371587);
+    SimpleBrot::QuadDouble center_im(0.1318259042053120);
+    SimpleBrot::QuadDouble half_re(4e-12);
+    SimpleBrot::QuadDouble half_im(3e-12);
+
+    SimpleBrot::Tile frame = SimpleBrot::FrameTile(
+      std::complex<SimpleBrot::QuadDouble>(center_re - half_re, center_im - half_im),
+      std::complex<SimpleBrot::QuadDouble>(center_re + half_re, center_im + half_im), 64, 48, 2048, 2);
+
+    WHEN("The head rank publishes its reference")
+    {
+      std::shared_ptr<SimpleBrot::ReferenceCache> cache(new SimpleBrot::ReferenceCache());
+      SimpleBrot::ReferenceBroadcaster broadcaster(cache, communicator, head_rank);
+
+      if(mpi::comm::rank(communicator) == head_rank)
+      {
+        broadcaster.publish(5, frame);
+      }
+
+      std::shared_ptr<SimpleBrot::FrameReference const> reference = cache->lookup(5);
+
+      THEN("Every rank holds the reference a local build gives")
+      {
+        SimpleBrot::FrameReference const expected(frame);
+
+        REQUIRE(reference != nullptr);
+        REQUIRE(reference->orbit.Length() == expected.orbit.Length());
+        REQUIRE(reference->series.Skip() == expected.series.Skip());
+        REQUIRE(reference->deltaStart == expected.deltaStart);
+        REQUIRE(reference->step == expected.step);
+
+        bool orbits_match = true;
+        for(unsigned i = 0; i < reference->orbit.Length(); i++)
+        {
+          orbits_match = orbits_match && (reference->orbit.Get(i) == expected.orbit.Get(i));
+        }
+        REQUIRE(orbits_match == true);
+        REQUIRE(reference->series.Delta(expected.step) == expected.series.Delta(expected.step));
+      }
+
+      THEN("Earlier frames that were never published have no reference")
+      {
+        REQUIRE(cache->lookup(4) == nullptr);
+      }
+    }
+  }
+}
@@ -0,0 +1,115 @@
+// This is a catch module
+#include "catch.hpp"
+
+
+// Internal
+#include "compute/Tile.hpp"
+#include "compute/TileWork.hpp"
+#include "util/Scatterer.hpp"
+#include "util/Gatherer.hpp"
+#include "mpi/comm.hpp"
+
+// External
+#include "mpi.h"
+
+// Standard
+#include <complex>
+#include <thread>
+#include <vector>
+
+
+SCENARIO(
+  "Distributed tile rendering test")
+{
+  unsigned queue_length = 256;
+
+  int head_rank = 0;
+  MPI_Comm communicator = MPI_COMM_WORLD;
+
+  std::shared_ptr<util::Queue<SimpleBrot::TileRequest>> request_queue(nullptr);
+  std::shared_ptr<util::Queue<SimpleBrot::TileRequest>> local_request_queue(new util::Queue<SimpleBrot::TileRequest>(queue_length));
+
+  std::shared_ptr<util::Queue<SimpleBrot::TileResult>> local_result_queue(new util::Queue<SimpleBrot::TileResult>(queue_length));
+  std::shared_ptr<util::Queue<SimpleBrot::TileResult>> result_queue(nullptr);
+
+  if(mpi::comm::rank(communicator) == head_rank)
+  {
+    request_queue = std::shared_ptr<util::Queue<SimpleBrot::TileRequest>>(new util::Queue<SimpleBrot::TileRequest>(queue_length));
+    result_queue = std::shared_ptr<util::Queue<SimpleBrot::TileResult>>(new util::Queue<SimpleBrot::TileResult>(queue_length));
+  }
+
+  GIVEN("A frame split into tiles")
+  {
+    SimpleBrot::Tile frame = SimpleBrot::FrameTile(
+      std::complex<SimpleBrot::QuadDouble>(-2.5, -1.5), std::complex<SimpleBrot::QuadDouble>(1.5, 1.5), 160, 120, 128, 2, 2);
+    frame.precision = SimpleBrot::Precision::Double;
+
+    std::vector<SimpleBrot::Tile> tiles = SimpleBrot::SplitFrame(frame, 32, 32);
+
+    std::vector<SimpleBrot::TileRequest> requests;
+    for(unsigned i = 0; i < tiles.size(); i++)
+    {
+      requests.push_back(SimpleBrot::TileRequest(7, i, tiles[i]));
+    }
+
+    std::vector<SimpleBrot::TileResult> results(tiles.size());
+
+    WHEN("The tiles are rendered across multiple ranks using scatterer, worker & gatherer")
+    {
+      // Declared against the dataflow so they are torn down along it
+      util::Gatherer<SimpleBrot::TileResult> gatherer(local_result_queue, result_queue, communicator, head_rank);
+      SimpleBrot::TileWorker worker(local_request_queue, local_result_queue, 2);
+      util::Scatterer<SimpleBrot::TileRequest> scatterer(request_queue, local_request_queue, communicator, head_rank);
+
+      if(mpi::comm::rank(communicator) == head_rank)
+      {
+        std::thread enqueue_thread(&util::Queue<SimpleBrot::TileRequest>::enqueueVector, &(*request_queue), std::ref(requests));
+        std::thread dequeue_thread(&util::Queue<SimpleBrot::TileResult>::dequeueVector, &(*result_queue), std::ref(results));
+
+        enqueue_thread.join();
+        dequeue_thread.join();
+      }
+
+      THEN("The stitched frame on the head rank matches a local render")
+      {
+        if(mpi::comm::rank(communicator) == head_rank)
+        {
+          Buffer2D<float> whole;
+          SimpleBrot::RenderTile(frame, whole);
+
+          std::vector<unsigned> seen(tiles.size(), 0);
+          unsigned mismatches = 0;
+
+          for(SimpleBrot::TileResult const& result : results)
+          {
+            REQUIRE(result.frame == 7);
+            REQUIRE(result.index < tiles.size());
+            seen[result.index]++;
+
+            SimpleBrot::Tile const& tile = tiles[result.index];
+            REQUIRE(result.x == tile.x);
+            REQUIRE(result.y == tile.y);
+            REQUIRE(result.width == tile.width);
+            REQUIRE(result.height == tile.height);
+            REQUIRE(result.values.size() == tile.width * tile.height);
+            REQUIRE(result.stats.iteratedPixels + result.stats.filledPixels >= tile.width * tile.height);
+
+            for(unsigned i = 0; i < result.height; i++)
+            {
+              for(unsigned j = 0; j < result.width; j++)
+              {
+                mismatches += (result.Get(j, i) != whole.Get(result.x + j, result.y + i));
+              }
+            }
+          }
+
+          for(unsigned count : seen)
+          {
+            REQUIRE(count == 1);
+          }
+          REQUIRE(mismatches == 0);
+        }
+      }
+    }
+  }
+}
@@ -22,9 +22,6 @@
 #define MPIBROT_UTIL_DISTRIBUTOR_RX_REQUEST_TAG 1
 #define MPIBROT_UTIL_DISTRIBUTOR_TAG_COUNTER_BASE 10
 
-// Stop signal
-#define MPIBROT_UTIL_DISTRIBUTOR_STOP_SIGNAL -1
-
 
 namespace util
 {
@@ -33,8 +30,8 @@ namespace util
   class Distributor
   {
   private:
-    std::shared_ptr<util::Queue<T>> m_input_queue;
-    std::shared_ptr<util::Queue<T>> m_output_queue;
+    std::shared_ptr<util::BoundedQueue<T>> m_input_queue;
+    std::shared_ptr<util::BoundedQueue<T>> m_output_queue;
 
     MPI_Comm m_comm_all;
 
@@ -186,8 +183,6 @@ namespace util
 
     void receiveThreadMain(int const t_signal_handler_rank, int const t_ack_tag, int const t_data_tag)
     {
-      T rx_data;
-
       RxAckFrame rx_ack;
       RxRequestFrame const rx_request = {
         mpi::comm::rank(m_comm_all),
@@ -205,17 +200,16 @@ namespace util
           break;
         }
 
+        T rx_data;
         rx_data.mpiReceive(rx_ack.rank, t_data_tag, m_comm_all);
 
-        m_output_queue->enqueue(rx_data);
+        m_output_queue->enqueue(std::move(rx_data));
       }
     }
 
 
     void transmitThreadMain(int const t_ack_tag)
     {
-      std::pair<int, T> tx_signal_data_pair;
-
       TxAckFrame tx_ack;
       TxRequestFrame const tx_request = {
         mpi::comm::rank(m_comm_all),
@@ -225,9 +219,9 @@ namespace util
 
       while(1)
       {
-        tx_signal_data_pair = m_input_queue->dequeueWithSignal();
+        boost::optional<T> tx_data = m_input_queue->dequeue();
 
-        if(tx_signal_data_pair.first == MPIBROT_UTIL_DISTRIBUTOR_STOP_SIGNAL)
+        if(!tx_data)
         {
           break;
         }
@@ -235,7 +229,7 @@ namespace util
         this->sendTxRequest(tx_request, m_my_signal_handler_rank);
         tx_ack = this->receiveTxAcknowledge(m_my_signal_handler_rank, t_ack_tag);
 
-        tx_signal_data_pair.second.mpiSend(tx_ack.rank, tx_ack.data_tag, m_comm_all);
+        tx_data->mpiSend(tx_ack.rank, tx_ack.data_tag, m_comm_all);
       }
     }
 
@@ -243,8 +237,8 @@ namespace util
   // Methods
   public:
     Distributor(
-      std::shared_ptr<util::Queue<T>> t_input_queue,
-      std::shared_ptr<util::Queue<T>> t_output_queue,
+      std::shared_ptr<util::BoundedQueue<T>> t_input_queue,
+      std::shared_ptr<util::BoundedQueue<T>> t_output_queue,
       MPI_Comm const t_basis_communicator,
       unsigned const t_signal_group_count = 1,
       unsigned const t_transmit_thread_count = 1,
@@ -306,11 +300,8 @@ namespace util
     {
       mpi::error::check(MPI_Barrier(m_comm_all));
 
-      // Send stop signals to transmit threads
-      for(unsigned i = 0; i < m_transmit_threads.size(); i++)
-      {
-        this->m_input_queue->enqueueWithSignal(std::make_pair(MPIBROT_UTIL_DISTRIBUTOR_STOP_SIGNAL, T()));
-      }
+      // Transmit threads stop once the input queue is drained
+      this->m_input_queue->close();
 
       // Join transmit threads
       for(unsigned i = 0; i < m_transmit_threads.size(); i++)
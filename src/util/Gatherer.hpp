@@ -18,8 +18,6 @@
 #define MPIBROT_UTIL_GATHERER_TX_REQUEST_TAG 0
 #define MPIBROT_UTIL_GATHERER_TAG_COUNTER_BASE 10
 
-#define MPIBROT_UTIL_GATHERER_STOP_SIGNAL -1
-
 
 namespace util
 {
@@ -28,8 +26,8 @@ namespace util
   class Gatherer
   {
   private:
-    std::shared_ptr<util::Queue<T>> m_input_queue;
-    std::shared_ptr<util::Queue<T>> m_output_queue;
+    std::shared_ptr<util::BoundedQueue<T>> m_input_queue;
+    std::shared_ptr<util::BoundedQueue<T>> m_output_queue;
 
     MPI_Comm m_comm;
 
@@ -105,7 +103,6 @@ namespace util
 
     void transmitThreadMain(int const t_ack_tag)
     {
-      std::pair<int, T> signal_data_pair;
       TxAckFrame ack;
 
       TxRequestFrame const tx_request = {
@@ -116,9 +113,9 @@ namespace util
 
       while(1)
       {
-        signal_data_pair = m_input_queue->dequeueWithSignal();
+        boost::optional<T> data = m_input_queue->dequeue();
 
-        if(signal_data_pair.first == MPIBROT_UTIL_GATHERER_STOP_SIGNAL)
+        if(!data)
         {
           break;
         }
@@ -132,14 +129,13 @@ namespace util
           exit(1);
         }
 
-        signal_data_pair.second.mpiSend(m_head_node, ack.data_tag, m_comm);
+        data->mpiSend(m_head_node, ack.data_tag, m_comm);
       }
     }
 
 
     void receiveThreadMain(int const t_data_tag)
     {
-      T tx_data;
       TxRequestFrame tx_request;
 
       TxAckFrame const tx_ack = {
@@ -158,8 +154,9 @@ namespace util
 
         this->sendTxAcknowledge(tx_ack, tx_request.rank, tx_request.ack_tag);
 
+        T tx_data;
         tx_data.mpiReceive(tx_request.rank, t_data_tag, m_comm);
-        m_output_queue->enqueue(tx_data);
+        m_output_queue->enqueue(std::move(tx_data));
       }
     }
 
@@ -167,8 +164,8 @@ namespace util
   // Methods
   public:
     Gatherer(
-      std::shared_ptr<util::Queue<T>> t_input_queue,
-      std::shared_ptr<util::Queue<T>> t_output_queue,
+      std::shared_ptr<util::BoundedQueue<T>> t_input_queue,
+      std::shared_ptr<util::BoundedQueue<T>> t_output_queue,
       MPI_Comm const t_communicator,
       int const t_head_node = 0,
       unsigned const t_transmit_thread_count = 1,
@@ -222,6 +219,17 @@ namespace util
       // Destructor must be called collectively
       mpi::error::check(MPI_Barrier(m_comm));
 
+      // Send everything still queued while the head is still receiving
+      m_input_queue->close();
+
+      for(unsigned i = 0; i < m_transmit_threads.size(); i++)
+      {
+        m_transmit_threads[i].join();
+      }
+
+      // Every rank has sent its last item before the head stops receiving
+      mpi::error::check(MPI_Barrier(m_comm));
+
       if(mpi::comm::rank(m_comm) == m_head_node)
       {
         TxRequestFrame const tx_stop_signal = {
@@ -241,16 +249,6 @@ namespace util
         }
       }
 
-      for(unsigned i = 0; i < m_transmit_threads.size(); i++)
-      {
-        m_input_queue->enqueueWithSignal(std::make_pair(MPIBROT_UTIL_GATHERER_STOP_SIGNAL, T()));
-      }
-
-      for(unsigned i = 0; i < m_transmit_threads.size(); i++)
-      {
-        m_transmit_threads[i].join();
-      }
-
       mpi::error::check(MPI_Comm_free(&m_comm));
     }
   };
@@ -0,0 +1,75 @@
+#ifndef MPIBROT_UTIL_PARKER_INCLUDED
+#define MPIBROT_UTIL_PARKER_INCLUDED
+
+
+// Standard
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+
+namespace util
+{
+
+  // Somewhere for threads blocked on a lock-free structure to sleep
+  // Waking costs a fence and a load unless someone is actually parked.
+  class Parker
+  {
+  private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::atomic<unsigned> m_parked;
+
+  public:
+    Parker() :
+      m_parked(0)
+    {}
+
+
+    // Sleep until t_ready() holds, which is re-checked after registering
+    template<class Ready>
+    void park(Ready t_ready)
+    {
+      std::unique_lock<decltype(m_mutex)> lock(m_mutex);
+      m_parked.fetch_add(1);
+      m_condition.wait(lock, t_ready);
+      m_parked.fetch_sub(1);
+    }
+
+
+    // Call after making up to t_count parked threads' conditions true
+    // The fence orders that update before reading the parked count,
+    // pairing with the increment park makes before it re-checks.
+    void wake(unsigned const t_count = 1)
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      unsigned const parked = m_parked.load(std::memory_order_relaxed);
+
+      if(parked > 0)
+      {
+        std::lock_guard<decltype(m_mutex)> lock(m_mutex);
+
+        for(unsigned i = 0; i < t_count && i < parked; i++)
+        {
+          m_condition.notify_one();
+        }
+      }
+    }
+
+
+    // Call after making every parked thread's condition true
+    void wakeAll()
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if(m_parked.load(std::memory_order_relaxed) > 0)
+      {
+        std::lock_guard<decltype(m_mutex)> lock(m_mutex);
+        m_condition.notify_all();
+      }
+    }
+  };
+
+} // namespace util
+
+#endif // MPIBROT_UTIL_PARKER_INCLUDED
@@ -3,123 +3,414 @@
 
 
 // Internal
-#include "util/CountingSemaphore.hpp"
+#include "util/Parker.hpp"
+
+// External
+#include "boost/optional.hpp"
 
 // Standard
+#include <atomic>
+#include <cstddef>
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
+#include <thread>
 #include <utility>
 
 
+// Assumed cache line size, the queue ends are padded apart by this much
+#define MPIBROT_QUEUE_CACHE_LINE 64
+
+// Times a blocked thread yields and retries before it parks
+#define MPIBROT_QUEUE_SPIN_COUNT 64
+
+
 namespace util
 {
 
   // Base class for things that you can enqueue stuff to
+  // Enqueueing fails, returning false, once the target has been closed.
   template<class T>
   class Enqueue
   {
   public:
-    virtual void enqueue(T t_data) = 0;
+    virtual bool enqueue(T t_data) = 0;
 
-    void enqueueVector(std::vector<T> const & t_data)
+    // Enqueue every item of t_data, moving them out of it
+    virtual bool enqueueBatch(std::vector<T> && t_data)
     {
       for(unsigned i = 0; i < t_data.size(); i++)
       {
-        this->enqueue(t_data[i]);
+        if(!this->enqueue(std::move(t_data[i])))
+        {
+          return false;
+        }
       }
+
+      return true;
+    }
+
+    bool enqueueVector(std::vector<T> const & t_data)
+    {
+      return this->enqueueBatch(std::vector<T>(t_data));
     }
   };
 
 
   // Base class for things that you can dequeue stuff from
+  // Dequeueing gives nothing once the source is closed and drained.
   template<class T>
   class Dequeue
   {
   public:
-    virtual T dequeue() = 0;
+    virtual boost::optional<T> dequeue() = 0;
 
-    void dequeueVector(std::vector<T> & t_data)
+    // Returns how many of t_data were filled
+    virtual size_t dequeueVector(std::vector<T> & t_data)
     {
       for(unsigned i = 0; i < t_data.size(); i++)
       {
-        t_data[i] = this->dequeue();
+        boost::optional<T> data = this->dequeue();
+
+        if(!data)
+        {
+          return i;
+        }
+
+        t_data[i] = std::move(*data);
       }
+
+      return t_data.size();
     }
   };
 
 
+  // Interface shared by the bounded blocking queues
+  // Worker, Scatterer, Gatherer and Distributor accept any of them. Closing
+  // a queue wakes everyone blocked on it, items already queued can still be
+  // dequeued, after which dequeue gives nothing. Items enqueued at the same
+  // time as the queue closes may be lost, so close once producers are done.
   template<class T>
-  class Queue : public Enqueue<T>, public Dequeue<T>
+  class BoundedQueue : public Enqueue<T>, public Dequeue<T>
   {
-  private:
-    unsigned m_front = 0;
-    unsigned m_back = 0;
-    std::vector<std::pair<int, T>> m_buffer;
-    std::unique_ptr<util::CountingSemaphore> m_sem_data;
-    std::unique_ptr<util::CountingSemaphore> m_sem_free_space;
-    std::mutex m_mutex;
+  public:
+    virtual void close() = 0;
+    virtual bool closed() const = 0;
+    virtual unsigned size() const = 0;
 
+    // Block until something is queued, then take up to t_count items
+    // Empty only once the queue is closed and drained.
+    virtual std::vector<T> dequeueUpTo(unsigned const t_count) = 0;
 
-  public:
-    Queue(unsigned const t_size) :
-      m_front(0),
-      m_back(0),
-      m_buffer(std::vector<std::pair<int, T>>(t_size, std::make_pair(0, T()))),
-      m_sem_data(new util::CountingSemaphore(0)),
-      m_sem_free_space(new util::CountingSemaphore(t_size))
+    virtual ~BoundedQueue()
     {}
+  };
+
+
+  // Bounded multi-producer/multi-consumer queue
+  // A ring of sequence numbered slots (after Dmitry Vyukov). Producers and
+  // consumers claim a run of consecutive ready slots with one
+  // compare-and-swap on their end's position, then publish each slot
+  // through its sequence, so neither side takes a lock and a batch costs
+  // one claim however long it is. Sequences advance in steps of two so a
+  // single slot ring is unambiguous. A blocked thread spins briefly, then
+  // parks on a condition variable which is only signalled when someone is
+  // actually parked. Items are constructed in their slot or moved in, and
+  // moved out again, so move-only types work and nothing is copied.
+  template<class T>
+  class Queue : public BoundedQueue<T>
+  {
+  private:
+    struct Slot
+    {
+      std::atomic<size_t> sequence;
+      boost::optional<T> data;
+    };
+
+    // Keep the two ends on separate cache lines
+    char m_pad_front[MPIBROT_QUEUE_CACHE_LINE];
+    std::atomic<size_t> m_enqueue_position;
+    char m_pad_enqueue[MPIBROT_QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_dequeue_position;
+    char m_pad_dequeue[MPIBROT_QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>)];
+
+    size_t const m_capacity;
+    std::unique_ptr<Slot[]> m_slots;
 
+    std::atomic<bool> m_closed;
 
-    inline void enqueueWithSignal(std::pair<int, T> const t_signal_data_pair)
+    util::Parker m_producers;
+    util::Parker m_consumers;
+
+
+    // Claim up to t_count consecutive slots from t_position onwards
+    // A slot at position p is ready for producers when its sequence is 2p
+    // and for consumers when it is 2p + 1, t_ready picks which. Returns the
+    // number claimed, zero if the first slot is not ready.
+    size_t claim(
+      std::atomic<size_t> & t_position,
+      size_t const t_ready,
+      size_t const t_count,
+      size_t & t_first)
     {
-      m_sem_free_space->take();
+      size_t position = t_position.load(std::memory_order_relaxed);
 
+      while(1)
       {
-        std::lock_guard<decltype(m_mutex)> lock(m_mutex);
-        m_buffer[m_back] = t_signal_data_pair;
-        m_back = (m_back + 1) % m_buffer.size();
+        size_t count = 0;
+        std::ptrdiff_t difference = 0;
+
+        while(count < t_count)
+        {
+          size_t const sequence = m_slots[(position + count) % m_capacity].sequence.load(std::memory_order_acquire);
+          difference = (std::ptrdiff_t)sequence - (std::ptrdiff_t)(2 * (position + count) + t_ready);
+
+          if(difference != 0)
+          {
+            break;
+          }
+
+          count++;
+        }
+
+        if(count > 0)
+        {
+          if(t_position.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+          {
+            t_first = position;
+            return count;
+          }
+        }
+        else if(difference > 0)
+        {
+          // Someone else moved this end on since we read it
+          position = t_position.load(std::memory_order_relaxed);
+        }
+        else
+        {
+          return 0;
+        }
       }
+    }
+
+
+    // Slot states as seen right now, only used to decide whether to park
+    bool full() const
+    {
+      size_t const position = m_enqueue_position.load();
+      return m_slots[position % m_capacity].sequence.load() != 2 * position;
+    }
 
-      m_sem_data->give();
+    bool empty() const
+    {
+      size_t const position = m_dequeue_position.load();
+      return m_slots[position % m_capacity].sequence.load() != 2 * position + 1;
     }
 
 
-    inline void enqueue(T const t_data)
+    // Enqueue t_count items, t_store(i, data) fills in the i'th
+    // Returns false if the queue closed before they were all enqueued.
+    template<class Store>
+    bool enqueueRange(size_t const t_count, Store t_store)
     {
-      std::pair<int, T> signal_data_pair = std::make_pair(0, t_data);
-      this->enqueueWithSignal(signal_data_pair);
+      size_t done = 0;
+      unsigned spin = 0;
+
+      while(done < t_count)
+      {
+        if(m_closed.load())
+        {
+          return false;
+        }
+
+        size_t first;
+        size_t const count = this->claim(m_enqueue_position, 0, t_count - done, first);
+
+        if(count == 0)
+        {
+          if(spin++ < MPIBROT_QUEUE_SPIN_COUNT)
+          {
+            std::this_thread::yield();
+          }
+          else
+          {
+            m_producers.park([this] {return !this->full() || m_closed.load();});
+          }
+          continue;
+        }
+
+        for(size_t i = 0; i < count; i++)
+        {
+          Slot & slot = m_slots[(first + i) % m_capacity];
+          t_store(done + i, slot.data);
+          slot.sequence.store(2 * (first + i) + 1, std::memory_order_release);
+        }
+
+        done += count;
+        spin = 0;
+        m_consumers.wake(count);
+      }
+
+      return true;
     }
 
 
-    inline std::pair<int, T> dequeueWithSignal()
+    // Dequeue t_count items, or once anything arrives if t_any, passing
+    // each to t_sink(i, data) to move out. Returns the number dequeued,
+    // which is short only if the queue is closed and drained.
+    template<class Sink>
+    size_t dequeueRange(size_t const t_count, bool const t_any, Sink t_sink)
     {
-      m_sem_data->take();
+      size_t done = 0;
+      unsigned spin = 0;
 
-      std::pair<int, T> signal_data_pair;
+      while(done < t_count && !(t_any && done > 0))
       {
-        std::lock_guard<decltype(m_mutex)> lock(m_mutex);
-        signal_data_pair = m_buffer[m_front];
-        m_buffer[m_front] = std::make_pair(0, T());
-        m_front = (m_front + 1) % m_buffer.size();
+        // Read before claiming, so anything enqueued before the queue
+        // closed is visible to the claim
+        bool const closed = m_closed.load();
+
+        size_t first;
+        size_t const count = this->claim(m_dequeue_position, 1, t_count - done, first);
+
+        if(count == 0)
+        {
+          if(closed)
+          {
+            break;
+          }
+          else if(spin++ < MPIBROT_QUEUE_SPIN_COUNT)
+          {
+            std::this_thread::yield();
+          }
+          else
+          {
+            m_consumers.park([this] {return !this->empty() || m_closed.load();});
+          }
+          continue;
+        }
+
+        for(size_t i = 0; i < count; i++)
+        {
+          Slot & slot = m_slots[(first + i) % m_capacity];
+          t_sink(done + i, slot.data);
+          slot.data = boost::none;
+          slot.sequence.store(2 * (first + i + m_capacity), std::memory_order_release);
+        }
+
+        done += count;
+        spin = 0;
+        m_producers.wake(count);
       }
 
-      m_sem_free_space->give();
+      return done;
+    }
+
+
+  public:
+    Queue(unsigned const t_size) :
+      m_enqueue_position(0),
+      m_dequeue_position(0),
+      m_capacity(t_size),
+      m_slots(new Slot[t_size]),
+      m_closed(false)
+    {
+      // Positions are taken modulo the capacity
+      if(t_size == 0)
+      {
+        throw std::invalid_argument("Queue capacity must be positive");
+      }
+
+      for(size_t i = 0; i < m_capacity; i++)
+      {
+        m_slots[i].sequence.store(2 * i, std::memory_order_relaxed);
+      }
+    }
 
-      return signal_data_pair;
+
+    bool enqueue(T t_data)
+    {
+      return this->emplace(std::move(t_data));
+    }
+
+
+    // Construct the item directly in its slot
+    template<class... Args>
+    bool emplace(Args && ... t_args)
+    {
+      return this->enqueueRange(1, [&t_args...](size_t, boost::optional<T> & t_data)
+      {
+        t_data.emplace(std::forward<Args>(t_args)...);
+      });
+    }
+
+
+    // Enqueued in as few claims as the free space allows
+    bool enqueueBatch(std::vector<T> && t_data)
+    {
+      return this->enqueueRange(t_data.size(), [&t_data](size_t const i, boost::optional<T> & t_slot_data)
+      {
+        t_slot_data = std::move(t_data[i]);
+      });
+    }
+
+
+    boost::optional<T> dequeue()
+    {
+      boost::optional<T> data;
+
+      this->dequeueRange(1, false, [&data](size_t, boost::optional<T> & t_slot_data)
+      {
+        data = std::move(t_slot_data);
+      });
+
+      return data;
+    }
+
+
+    // Dequeued in as few claims as the queued items allow
+    size_t dequeueVector(std::vector<T> & t_data)
+    {
+      return this->dequeueRange(t_data.size(), false, [&t_data](size_t const i, boost::optional<T> & t_slot_data)
+      {
+        t_data[i] = std::move(*t_slot_data);
+      });
+    }
+
+
+    std::vector<T> dequeueUpTo(unsigned const t_count)
+    {
+      std::vector<T> data;
+      data.reserve(t_count);
+
+      this->dequeueRange(t_count, true, [&data](size_t, boost::optional<T> & t_slot_data)
+      {
+        data.push_back(std::move(*t_slot_data));
+      });
+
+      return data;
+    }
+
+
+    // Stop accepting items and wake everyone blocked on the queue
+    void close()
+    {
+      m_closed.store(true);
+      m_producers.wakeAll();
+      m_consumers.wakeAll();
     }
 
 
-    inline T dequeue()
+    bool closed() const
     {
-      std::pair<int, T> signal_data_pair = this->dequeueWithSignal();
-      return signal_data_pair.second;
+      return m_closed.load();
     }
 
 
     unsigned size() const
     {
-      return m_buffer.size();
+      return m_capacity;
     }
   };
 
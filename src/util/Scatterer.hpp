@@ -18,8 +18,6 @@
 #define MPIBROT_UTIL_SCATTERER_RX_REQUEST_TAG 0
 #define MPIBROT_UTIL_SCATTERER_TAG_COUNTER_BASE 10
 
-#define MPIBROT_UTIL_SCATTERER_STOP_SIGNAL -1
-
 
 namespace util
 {
@@ -28,8 +26,8 @@ namespace util
   class Scatterer
   {
   private:
-    std::shared_ptr<util::Queue<T>> m_input_queue;
-    std::shared_ptr<util::Queue<T>> m_output_queue;
+    std::shared_ptr<util::BoundedQueue<T>> m_input_queue;
+    std::shared_ptr<util::BoundedQueue<T>> m_output_queue;
 
     MPI_Comm m_comm;
 
@@ -106,7 +104,6 @@ namespace util
 
     void transmitThreadMain()
     {
-      std::pair<int, T> signal_data_pair;
       RxRequestFrame rx_request;
 
       RxAckFrame const rx_ack = {
@@ -116,9 +113,9 @@ namespace util
 
       while(1)
       {
-        signal_data_pair = m_input_queue->dequeueWithSignal();
+        boost::optional<T> data = m_input_queue->dequeue();
 
-        if(signal_data_pair.first == MPIBROT_UTIL_SCATTERER_STOP_SIGNAL)
+        if(!data)
         {
           break;
         }
@@ -126,14 +123,13 @@ namespace util
         rx_request = this->receiveRxRequest();
         this->sendRxAcknowledge(rx_ack, rx_request.rank, rx_request.ack_tag);
 
-        signal_data_pair.second.mpiSend(rx_request.rank, rx_request.data_tag, m_comm);
+        data->mpiSend(rx_request.rank, rx_request.data_tag, m_comm);
       }
     }
 
 
     void receiveThreadMain(int const t_ack_tag, int const t_data_tag)
     {
-      T rx_data;
       RxAckFrame rx_ack;
 
       RxRequestFrame const rx_request = {
@@ -158,8 +154,9 @@ namespace util
           exit(1);
         }
 
+        T rx_data;
         rx_data.mpiReceive(rx_ack.rank, t_data_tag, m_comm);
-        m_output_queue->enqueue(rx_data);
+        m_output_queue->enqueue(std::move(rx_data));
       }
     }
 
@@ -167,8 +164,8 @@ namespace util
   // Methods
   public:
     Scatterer(
-      std::shared_ptr<util::Queue<T>> t_input_queue,
-      std::shared_ptr<util::Queue<T>> t_output_queue,
+      std::shared_ptr<util::BoundedQueue<T>> t_input_queue,
+      std::shared_ptr<util::BoundedQueue<T>> t_output_queue,
       MPI_Comm const t_communicator,
       int const t_head_node = 0,
       unsigned const t_transmit_thread_count = 1,
@@ -225,10 +222,7 @@ namespace util
 
       if(mpi::comm::rank(m_comm) == m_head_node)
       {
-        for(unsigned i = 0; i < m_transmit_threads.size(); i++)
-        {
-          m_input_queue->enqueueWithSignal(std::make_pair(MPIBROT_UTIL_SCATTERER_STOP_SIGNAL, T()));
-        }
+        m_input_queue->close();
 
         for(unsigned i = 0; i < m_transmit_threads.size(); i++)
         {
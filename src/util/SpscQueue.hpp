@@ -0,0 +1,298 @@
+#ifndef MPIBROT_UTIL_SPSC_QUEUE_INCLUDED
+#define MPIBROT_UTIL_SPSC_QUEUE_INCLUDED
+
+
+// Internal
+#include "util/Parker.hpp"
+#include "util/Queue.hpp"
+
+// External
+#include "boost/optional.hpp"
+
+// Standard
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace util
+{
+
+  // Bounded single-producer/single-consumer queue
+  // Only one thread may enqueue and only one may dequeue, in exchange the
+  // fast path is a load and a store on each side with no read-modify-write,
+  // and a batch is published with one store however long it is.
+  // The head and tail count up forever and each live on their own cache
+  // line, and each side keeps a cached copy of the other's index so it only
+  // touches the other line when the ring looks full or empty.
+  template<class T>
+  class SpscQueue : public BoundedQueue<T>
+  {
+  private:
+    char m_pad_front[MPIBROT_QUEUE_CACHE_LINE];
+
+    // Consumer's line
+    std::atomic<size_t> m_head;
+    size_t m_cached_tail;
+    char m_pad_head[MPIBROT_QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+    // Producer's line
+    std::atomic<size_t> m_tail;
+    size_t m_cached_head;
+    char m_pad_tail[MPIBROT_QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+    size_t const m_capacity;
+    std::unique_ptr<boost::optional<T>[]> m_slots;
+
+    std::atomic<bool> m_closed;
+
+    util::Parker m_producer;
+    util::Parker m_consumer;
+
+
+    // Free slots for the producer, only re-reading the head when short
+    size_t writable(size_t const t_tail, size_t const t_wanted)
+    {
+      if(m_capacity - (t_tail - m_cached_head) < t_wanted)
+      {
+        m_cached_head = m_head.load(std::memory_order_acquire);
+      }
+
+      return m_capacity - (t_tail - m_cached_head);
+    }
+
+
+    // Queued items for the consumer, only re-reading the tail when short
+    size_t readable(size_t const t_head, size_t const t_wanted)
+    {
+      if(m_cached_tail - t_head < t_wanted)
+      {
+        m_cached_tail = m_tail.load(std::memory_order_acquire);
+      }
+
+      return m_cached_tail - t_head;
+    }
+
+
+    // Only used to decide whether to park
+    bool full() const
+    {
+      return m_tail.load() - m_head.load() == m_capacity;
+    }
+
+    bool empty() const
+    {
+      return m_tail.load() == m_head.load();
+    }
+
+
+    // Enqueue t_count items, t_store(i, data) fills in the i'th
+    // Each run of free slots is published with a single store to the tail.
+    // Returns false if the queue closed before they were all enqueued.
+    template<class Store>
+    bool enqueueRange(size_t const t_count, Store t_store)
+    {
+      size_t done = 0;
+      unsigned spin = 0;
+
+      while(done < t_count)
+      {
+        if(m_closed.load())
+        {
+          return false;
+        }
+
+        size_t const tail = m_tail.load(std::memory_order_relaxed);
+        size_t const count = std::min(this->writable(tail, t_count - done), t_count - done);
+
+        if(count == 0)
+        {
+          if(spin++ < MPIBROT_QUEUE_SPIN_COUNT)
+          {
+            std::this_thread::yield();
+          }
+          else
+          {
+            m_producer.park([this] {return !this->full() || m_closed.load();});
+          }
+          continue;
+        }
+
+        for(size_t i = 0; i < count; i++)
+        {
+          t_store(done + i, m_slots[(tail + i) % m_capacity]);
+        }
+
+        m_tail.store(tail + count, std::memory_order_release);
+
+        done += count;
+        spin = 0;
+        m_consumer.wake();
+      }
+
+      return true;
+    }
+
+
+    // Dequeue t_count items, or once anything arrives if t_any, passing
+    // each to t_sink(i, data) to move out. Returns the number dequeued,
+    // which is short only if the queue is closed and drained.
+    template<class Sink>
+    size_t dequeueRange(size_t const t_count, bool const t_any, Sink t_sink)
+    {
+      size_t done = 0;
+      unsigned spin = 0;
+
+      while(done < t_count && !(t_any && done > 0))
+      {
+        // Read before the tail, so anything enqueued before the queue
+        // closed is seen
+        bool const closed = m_closed.load();
+
+        size_t const head = m_head.load(std::memory_order_relaxed);
+        size_t const count = std::min(this->readable(head, t_count - done), t_count - done);
+
+        if(count == 0)
+        {
+          if(closed)
+          {
+            break;
+          }
+          else if(spin++ < MPIBROT_QUEUE_SPIN_COUNT)
+          {
+            std::this_thread::yield();
+          }
+          else
+          {
+            m_consumer.park([this] {return !this->empty() || m_closed.load();});
+          }
+          continue;
+        }
+
+        for(size_t i = 0; i < count; i++)
+        {
+          boost::optional<T> & slot = m_slots[(head + i) % m_capacity];
+          t_sink(done + i, slot);
+          slot = boost::none;
+        }
+
+        m_head.store(head + count, std::memory_order_release);
+
+        done += count;
+        spin = 0;
+        m_producer.wake();
+      }
+
+      return done;
+    }
+
+
+  public:
+    SpscQueue(unsigned const t_size) :
+      m_head(0),
+      m_cached_tail(0),
+      m_tail(0),
+      m_cached_head(0),
+      m_capacity(t_size),
+      m_slots(new boost::optional<T>[t_size]),
+      m_closed(false)
+    {
+      // Positions are taken modulo the capacity
+      if(t_size == 0)
+      {
+        throw std::invalid_argument("Queue capacity must be positive");
+      }
+    }
+
+
+    bool enqueue(T t_data)
+    {
+      return this->emplace(std::move(t_data));
+    }
+
+
+    // Construct the item directly in its slot
+    template<class... Args>
+    bool emplace(Args && ... t_args)
+    {
+      return this->enqueueRange(1, [&t_args...](size_t, boost::optional<T> & t_data)
+      {
+        t_data.emplace(std::forward<Args>(t_args)...);
+      });
+    }
+
+
+    bool enqueueBatch(std::vector<T> && t_data)
+    {
+      return this->enqueueRange(t_data.size(), [&t_data](size_t const i, boost::optional<T> & t_slot_data)
+      {
+        t_slot_data = std::move(t_data[i]);
+      });
+    }
+
+
+    boost::optional<T> dequeue()
+    {
+      boost::optional<T> data;
+
+      this->dequeueRange(1, false, [&data](size_t, boost::optional<T> & t_slot_data)
+      {
+        data = std::move(t_slot_data);
+      });
+
+      return data;
+    }
+
+
+    size_t dequeueVector(std::vector<T> & t_data)
+    {
+      return this->dequeueRange(t_data.size(), false, [&t_data](size_t const i, boost::optional<T> & t_slot_data)
+      {
+        t_data[i] = std::move(*t_slot_data);
+      });
+    }
+
+
+    std::vector<T> dequeueUpTo(unsigned const t_count)
+    {
+      std::vector<T> data;
+      data.reserve(t_count);
+
+      this->dequeueRange(t_count, true, [&data](size_t, boost::optional<T> & t_slot_data)
+      {
+        data.push_back(std::move(*t_slot_data));
+      });
+
+      return data;
+    }
+
+
+    // Stop accepting items and wake whoever is blocked on the queue
+    void close()
+    {
+      m_closed.store(true);
+      m_producer.wakeAll();
+      m_consumer.wakeAll();
+    }
+
+
+    bool closed() const
+    {
+      return m_closed.load();
+    }
+
+
+    unsigned size() const
+    {
+      return m_capacity;
+    }
+  };
+
+} // namespace util
+
+#endif // MPIBROT_UTIL_SPSC_QUEUE_INCLUDED
@@ -11,18 +11,18 @@
 #include <memory>
 
 
-// Worker exit signal value
-#define MPIBROT_WORKER_EXIT_SIGNAL -1
-
-
 namespace util
 {
 
+  // Threads that dequeue work items and hand them to processWorkItem
+  // Derived classes must call stop() in their destructor, the threads may
+  // still be running work items that use the derived class's members, and
+  // by the time ~Worker runs those are gone.
   template<class T_in>
   class Worker
   {
   private:
-    std::shared_ptr<util::Queue<T_in>> m_input_queue;
+    std::shared_ptr<util::BoundedQueue<T_in>> m_input_queue;
 
     std::vector<std::thread> m_worker_threads;
 
@@ -31,18 +31,16 @@ namespace util
   private:
     void workerMain()
     {
-      std::pair<int, T_in> data_signal_pair;
-
       while(1)
       {
-        data_signal_pair = m_input_queue->dequeueWithSignal();
+        boost::optional<T_in> data = m_input_queue->dequeue();
 
-        if(data_signal_pair.first == MPIBROT_WORKER_EXIT_SIGNAL)
+        if(!data)
         {
           break;
         }
 
-        processWorkItem(data_signal_pair.second);
+        processWorkItem(std::move(*data));
       }
     }
 
@@ -55,7 +53,7 @@ namespace util
   // Methods
   public:
     Worker(
-      std::shared_ptr<Queue<T_in>> t_input_queue,
+      std::shared_ptr<BoundedQueue<T_in>> t_input_queue,
       unsigned const t_thread_count) :
       m_input_queue(t_input_queue),
       m_worker_threads(std::vector<std::thread>(t_thread_count))
@@ -73,18 +71,26 @@ namespace util
     }
 
 
-    ~Worker()
+    // Threads finish what is already queued, then stop
+    // Closes the input queue, only returns once the threads are done.
+    void stop()
     {
-      for(unsigned i = 0; i < m_worker_threads.size(); i++)
-      {
-        m_input_queue->enqueueWithSignal(std::make_pair(MPIBROT_WORKER_EXIT_SIGNAL, T_in()));
-      }
+      m_input_queue->close();
 
       for(unsigned i = 0; i < m_worker_threads.size(); i++)
       {
-        m_worker_threads[i].join();
+        if(m_worker_threads[i].joinable())
+        {
+          m_worker_threads[i].join();
+        }
       }
     }
+
+
+    virtual ~Worker()
+    {
+      this->stop();
+    }
   };
 
 } // namespace util